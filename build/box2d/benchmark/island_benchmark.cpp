@@ -0,0 +1,253 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Compares the single threaded island solver with b2World::SetSolverThreadCount.
+// Each scene is stepped once per thread count from the same starting state. The final
+// body states and the sequence of PostSolve impulses must match the single threaded
+// run bit for bit.
+//
+// Usage: island-benchmark [columns] [steps] [thread counts...]
+
+#include "box2d/box2d.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+// Hashes every PostSolve impulse in the order they are reported.
+class ImpulseRecorder : public b2ContactListener
+{
+public:
+	ImpulseRecorder()
+	{
+		m_hash = 2166136261u;
+		m_count = 0;
+	}
+
+	void PostSolve(b2Contact* contact, const b2ContactImpulse* impulse) override
+	{
+		B2_NOT_USED(contact);
+		Hash(&impulse->count, sizeof(int32));
+		Hash(impulse->normalImpulses, impulse->count * sizeof(float));
+		Hash(impulse->tangentImpulses, impulse->count * sizeof(float));
+		++m_count;
+	}
+
+	void Hash(const void* data, size_t size)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < size; ++i)
+		{
+			m_hash = (m_hash ^ bytes[i]) * 16777619u;
+		}
+	}
+
+	uint32 m_hash;
+	int32 m_count;
+};
+
+enum SceneType
+{
+	e_boxStack,
+	e_circleStack,
+	e_mixed,
+	e_settle,
+	e_sceneCount
+};
+
+static const char* s_sceneNames[e_sceneCount] = { "box_stack", "circle_stack", "mixed", "settle" };
+
+// Columns of boxes or circles standing on one shared ground body, so each column is
+// its own island. The mixed scene replaces every fourth column with a jointed chain.
+// The settle scene uses short stacks that come to rest and fall asleep, then boxes dropped
+// from different heights land on some of them later and wake them up again.
+static void CreateScene(b2World* world, SceneType type, int32 columnCount)
+{
+	const int32 rowCount = type == e_settle ? 3 : 10;
+	const float spacing = 3.0f;
+
+	b2BodyDef groundDef;
+	b2Body* ground = world->CreateBody(&groundDef);
+
+	b2EdgeShape edge;
+	edge.Set(b2Vec2(-spacing, 0.0f), b2Vec2(spacing * columnCount, 0.0f));
+	ground->CreateFixture(&edge, 0.0f);
+
+	b2PolygonShape box;
+	box.SetAsBox(0.5f, 0.5f);
+
+	b2CircleShape circle;
+	circle.m_radius = 0.5f;
+
+	b2PolygonShape link;
+	link.SetAsBox(0.5f, 0.125f);
+
+	for (int32 i = 0; i < columnCount; ++i)
+	{
+		float x = spacing * i;
+
+		if (type == e_mixed && i % 4 == 3)
+		{
+			b2Body* prev = ground;
+			for (int32 j = 0; j < rowCount; ++j)
+			{
+				b2BodyDef bd;
+				bd.type = b2_dynamicBody;
+				bd.position.Set(x + 0.5f + j, 15.0f);
+				b2Body* body = world->CreateBody(&bd);
+				body->CreateFixture(&link, 20.0f);
+
+				b2RevoluteJointDef jd;
+				jd.Initialize(prev, body, b2Vec2(x + j, 15.0f));
+				world->CreateJoint(&jd);
+				prev = body;
+			}
+			continue;
+		}
+
+		for (int32 j = 0; j < rowCount; ++j)
+		{
+			b2BodyDef bd;
+			bd.type = b2_dynamicBody;
+
+			// Small offsets so the stacks topple differently.
+			float offset = 0.01f * ((i * 7 + j * 3) % 5 - 2);
+			bd.position.Set(x + offset, 0.5f + 1.05f * j);
+			b2Body* body = world->CreateBody(&bd);
+
+			b2FixtureDef fd;
+			fd.shape = type == e_circleStack ? (b2Shape*)&circle : (b2Shape*)&box;
+			fd.density = 1.0f;
+			fd.friction = 0.3f;
+			body->CreateFixture(&fd);
+		}
+
+		if (type == e_settle && i % 3 == 0)
+		{
+			b2BodyDef bd;
+			bd.type = b2_dynamicBody;
+			bd.position.Set(x, 20.0f + 10.0f * (i % 4));
+			b2Body* body = world->CreateBody(&bd);
+			body->CreateFixture(&box, 1.0f);
+		}
+	}
+}
+
+struct RunResult
+{
+	double milliseconds;
+	std::vector<float> state;
+	uint32 impulseHash;
+	int32 impulseCount;
+	int32 awakeCount;
+};
+
+static void RunScene(RunResult* result, SceneType type, int32 columnCount, int32 stepCount, int32 threadCount)
+{
+	b2World world(b2Vec2(0.0f, -10.0f));
+	world.SetSolverThreadCount(threadCount);
+
+	ImpulseRecorder recorder;
+	world.SetContactListener(&recorder);
+
+	CreateScene(&world, type, columnCount);
+
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	for (int32 i = 0; i < stepCount; ++i)
+	{
+		world.Step(1.0f / 60.0f, 8, 3);
+	}
+	result->milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	result->state.clear();
+	result->awakeCount = 0;
+	for (b2Body* b = world.GetBodyList(); b; b = b->GetNext())
+	{
+		const b2Transform& xf = b->GetTransform();
+		b2Vec2 v = b->GetLinearVelocity();
+		float state[] = { xf.p.x, xf.p.y, xf.q.s, xf.q.c, v.x, v.y, b->GetAngularVelocity(), b->IsAwake() ? 1.0f : 0.0f };
+		result->state.insert(result->state.end(), state, state + sizeof(state) / sizeof(float));
+		result->awakeCount += b->IsAwake() ? 1 : 0;
+	}
+
+	result->impulseHash = recorder.m_hash;
+	result->impulseCount = recorder.m_count;
+}
+
+int main(int argc, char** argv)
+{
+	int32 columnCount = argc > 1 ? atoi(argv[1]) : 200;
+	int32 stepCount = argc > 2 ? atoi(argv[2]) : 300;
+
+	std::vector<int32> threadCounts;
+	for (int32 i = 3; i < argc; ++i)
+	{
+		threadCounts.push_back(b2Max(atoi(argv[i]), 1));
+	}
+	if (argc <= 3)
+	{
+		threadCounts.push_back(1);
+		threadCounts.push_back(2);
+		threadCounts.push_back(4);
+		int32 hardwareThreads = (int32)std::thread::hardware_concurrency();
+		if (hardwareThreads > 4)
+		{
+			threadCounts.push_back(hardwareThreads);
+		}
+	}
+
+	printf("island-benchmark columns=%d steps=%d\n", columnCount, stepCount);
+
+	bool allMatch = true;
+	for (int32 type = 0; type < e_sceneCount; ++type)
+	{
+		RunResult serial;
+		RunScene(&serial, SceneType(type), columnCount, stepCount, 1);
+
+		for (size_t i = 0; i < threadCounts.size(); ++i)
+		{
+			RunResult parallel;
+			RunScene(&parallel, SceneType(type), columnCount, stepCount, threadCounts[i]);
+
+			bool match = parallel.state.size() == serial.state.size() &&
+				memcmp(parallel.state.data(), serial.state.data(), serial.state.size() * sizeof(float)) == 0 &&
+				parallel.impulseHash == serial.impulseHash &&
+				parallel.impulseCount == serial.impulseCount;
+			allMatch = allMatch && match;
+
+			printf("%-13s threads %2d  %8.3f ms/step  speedup %5.2fx  awake %5d  post solves %8d  %s\n",
+				s_sceneNames[type], threadCounts[i], parallel.milliseconds / stepCount,
+				serial.milliseconds / parallel.milliseconds, parallel.awakeCount, parallel.impulseCount,
+				match ? "ok" : "MISMATCH");
+		}
+	}
+
+	if (allMatch == false)
+	{
+		printf("FAILED: multithreaded results do not match the single threaded solver\n");
+	}
+
+	return allMatch ? 0 : 1;
+}
@@ -51,4 +51,32 @@ private:
 #endif
 };
 
+/// Functions called at the start and end of a named zone of a step, to pass the zones on to
+/// an external profiler. Zones on one thread are always nested. The begin function returns
+/// whether it began the zone, and the end function is only called for zones that were begun.
+typedef bool b2ProfileZoneBeginFcn(const char* name);
+typedef void b2ProfileZoneEndFcn();
+
+/// Set the functions called when a profile zone begins and ends. Pass nullptr to stop marking zones.
+/// Set them before stepping any world, they are shared by every world and thread.
+void b2SetProfileZoneCallbacks(b2ProfileZoneBeginFcn* beginFcn, b2ProfileZoneEndFcn* endFcn);
+
+/// Marks a profile zone from construction until destruction.
+class b2ProfileZone
+{
+public:
+	explicit b2ProfileZone(const char* name);
+	~b2ProfileZone();
+
+private:
+	b2ProfileZoneEndFcn* m_endFcn;
+};
+
+/// Mark the rest of the scope as a profile zone. Define B2_NO_PROFILE_ZONES to compile the zones out.
+#ifndef B2_NO_PROFILE_ZONES
+#define B2_PROFILE_ZONE(name) b2ProfileZone b2_profileZone(name)
+#else
+#define B2_PROFILE_ZONE(name)
+#endif
+
 #endif
@@ -37,7 +37,9 @@ struct b2JointDef;
 class b2Body;
 class b2Draw;
 class b2Fixture;
+class b2Island;
 class b2Joint;
+class b2TaskPool;
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -161,6 +163,16 @@ public:
 	void SetSubStepping(bool flag) { m_subStepping = flag; }
 	bool GetSubStepping() const { return m_subStepping; }
 
+	/// Set the number of threads used to solve islands, including the thread calling Step.
+	/// With more than one thread, islands that have no joints are solved in parallel on a
+	/// pool of worker threads; islands with joints are still solved on the calling thread.
+	/// The results are identical to the single threaded solver. Contact listener PostSolve
+	/// calls are made on the calling thread once every island has been solved.
+	/// The default of 1 solves everything on the calling thread.
+	/// @warning this should be called outside of a time step.
+	void SetSolverThreadCount(int32 count);
+	int32 GetSolverThreadCount() const { return m_solverThreadCount; }
+
 	/// Get the number of broad-phase proxies.
 	int32 GetProxyCount() const;
 
@@ -221,14 +233,23 @@ private:
 	friend class b2Controller;
 
 	void Solve(const b2TimeStep& step);
+	void SolveParallel(const b2TimeStep& step);
 	void SolveTOI(const b2TimeStep& step);
 
+	void BuildIsland(b2Island* island, b2Body* seed, b2Body** stack, int32 stackSize);
+
 	void DrawJoint(b2Joint* joint);
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
 
 	b2BlockAllocator m_blockAllocator;
 	b2StackAllocator m_stackAllocator;
 
+	// Used when m_solverThreadCount > 1. Worker 0 is the thread calling Step and
+	// uses m_stackAllocator, the others use m_workerAllocators[worker - 1].
+	int32 m_solverThreadCount;
+	b2TaskPool* m_taskPool;
+	b2StackAllocator* m_workerAllocators;
+
 	b2ContactManager m_contactManager;
 
 	b2Body* m_bodyList;
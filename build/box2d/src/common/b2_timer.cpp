@@ -123,3 +123,31 @@ float b2Timer::GetMilliseconds() const
 }
 
 #endif
+
+static b2ProfileZoneBeginFcn* s_profileZoneBeginFcn = nullptr;
+static b2ProfileZoneEndFcn* s_profileZoneEndFcn = nullptr;
+
+void b2SetProfileZoneCallbacks(b2ProfileZoneBeginFcn* beginFcn, b2ProfileZoneEndFcn* endFcn)
+{
+	s_profileZoneBeginFcn = beginFcn;
+	s_profileZoneEndFcn = endFcn;
+}
+
+b2ProfileZone::b2ProfileZone(const char* name)
+{
+	// keep the end function so the zone is closed even if the callbacks change in between,
+	// and forget it if the zone wasn't begun so nothing else is ended in its place
+	m_endFcn = s_profileZoneEndFcn;
+	if (m_endFcn && !s_profileZoneBeginFcn(name))
+	{
+		m_endFcn = nullptr;
+	}
+}
+
+b2ProfileZone::~b2ProfileZone()
+{
+	if (m_endFcn)
+	{
+		m_endFcn();
+	}
+}
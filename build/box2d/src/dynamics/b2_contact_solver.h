@@ -67,6 +67,7 @@ struct b2ContactSolverDef
 	int32 count;
 	b2Position* positions;
 	b2Velocity* velocities;
+	const int32* indices;	///< optional body island indices, two per contact
 	b2StackAllocator* allocator;
 };
 
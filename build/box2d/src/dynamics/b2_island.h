@@ -32,6 +32,7 @@ class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
 struct b2ContactVelocityConstraint;
+struct b2ContactImpulse;
 struct b2Profile;
 
 /// This is an internal class.
@@ -92,6 +93,17 @@ public:
 	int32 m_bodyCapacity;
 	int32 m_contactCapacity;
 	int32 m_jointCapacity;
+
+	// Set by b2World when islands are solved on multiple threads.
+	// m_contactIndices holds the island index of body A and body B for each contact.
+	// When it is null the contact solver uses b2Body::m_islandIndex instead.
+	// When m_impulses is set, Report stores the contact impulses there instead of
+	// calling the listener, and when m_deferSleep is set Solve only sets m_sleep
+	// instead of putting the bodies to sleep. b2World applies both afterwards.
+	const int32* m_contactIndices;
+	b2ContactImpulse* m_impulses;
+	bool m_deferSleep;
+	bool m_sleep;
 };
 
 #endif
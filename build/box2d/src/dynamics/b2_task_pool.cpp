@@ -0,0 +1,216 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "b2_task_pool.h"
+#include "box2d/b2_timer.h"
+
+#include <new>
+
+b2TaskPool::b2TaskPool(int32 workerCount)
+{
+	b2Assert(workerCount >= 1);
+
+	m_workerCount = workerCount;
+	m_queueCapacity = 0;
+	m_callback = nullptr;
+	m_context = nullptr;
+	m_generation = 0;
+	m_activeWorkers = 0;
+	m_exit = false;
+
+	m_queues = (b2TaskQueue*)b2Alloc(m_workerCount * sizeof(b2TaskQueue));
+	for (int32 i = 0; i < m_workerCount; ++i)
+	{
+		b2TaskQueue* queue = new (m_queues + i) b2TaskQueue;
+		queue->tasks = nullptr;
+		queue->head = 0;
+		queue->tail = 0;
+	}
+
+	// Worker 0 is the thread that calls Run, so it has no thread of its own.
+	m_threads = (std::thread*)b2Alloc((m_workerCount - 1) * sizeof(std::thread));
+	for (int32 i = 1; i < m_workerCount; ++i)
+	{
+		new (m_threads + i - 1) std::thread(&b2TaskPool::WorkerMain, this, i);
+	}
+}
+
+b2TaskPool::~b2TaskPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_exit = true;
+	}
+	m_startCondition.notify_all();
+
+	for (int32 i = 0; i < m_workerCount - 1; ++i)
+	{
+		m_threads[i].join();
+		m_threads[i].~thread();
+	}
+	b2Free(m_threads);
+
+	for (int32 i = 0; i < m_workerCount; ++i)
+	{
+		if (m_queues[i].tasks != nullptr)
+		{
+			b2Free(m_queues[i].tasks);
+		}
+		m_queues[i].~b2TaskQueue();
+	}
+	b2Free(m_queues);
+}
+
+void b2TaskPool::Run(int32 taskCount, b2TaskCallback* callback, void* context)
+{
+	// Waking the workers is not worth it for a single task.
+	if (m_workerCount == 1 || taskCount <= 1)
+	{
+		for (int32 i = 0; i < taskCount; ++i)
+		{
+			callback(i, 0, context);
+		}
+		return;
+	}
+
+	// Grow the queues. They keep their memory between runs so a step does not allocate.
+	int32 queueSize = (taskCount + m_workerCount - 1) / m_workerCount;
+	if (queueSize > m_queueCapacity)
+	{
+		for (int32 i = 0; i < m_workerCount; ++i)
+		{
+			if (m_queues[i].tasks != nullptr)
+			{
+				b2Free(m_queues[i].tasks);
+			}
+			m_queues[i].tasks = (int32*)b2Alloc(queueSize * sizeof(int32));
+		}
+		m_queueCapacity = queueSize;
+	}
+
+	// Deal the tasks out round robin. The workers are all waiting at this point,
+	// so the queues don't need locking until the start is signalled.
+	for (int32 i = 0; i < m_workerCount; ++i)
+	{
+		m_queues[i].head = 0;
+		m_queues[i].tail = 0;
+	}
+
+	for (int32 i = 0; i < taskCount; ++i)
+	{
+		b2TaskQueue* queue = m_queues + i % m_workerCount;
+		queue->tasks[queue->tail++] = i;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_callback = callback;
+		m_context = context;
+		m_activeWorkers = m_workerCount - 1;
+		++m_generation;
+	}
+	m_startCondition.notify_all();
+
+	RunTasks(0);
+
+	// Wait for the other workers to finish their last task.
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_activeWorkers > 0)
+	{
+		m_finishCondition.wait(lock);
+	}
+}
+
+void b2TaskPool::WorkerMain(int32 workerIndex)
+{
+	uint32 generation = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (m_exit == false && m_generation == generation)
+			{
+				m_startCondition.wait(lock);
+			}
+
+			if (m_exit)
+			{
+				return;
+			}
+
+			generation = m_generation;
+		}
+
+		RunTasks(workerIndex);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			--m_activeWorkers;
+			if (m_activeWorkers == 0)
+			{
+				m_finishCondition.notify_one();
+			}
+		}
+	}
+}
+
+void b2TaskPool::RunTasks(int32 workerIndex)
+{
+	B2_PROFILE_ZONE("b2TaskPool::RunTasks");
+
+	int32 taskIndex;
+	while (PopTask(workerIndex, &taskIndex) || StealTask(workerIndex, &taskIndex))
+	{
+		m_callback(taskIndex, workerIndex, m_context);
+	}
+}
+
+bool b2TaskPool::PopTask(int32 workerIndex, int32* taskIndex)
+{
+	b2TaskQueue* queue = m_queues + workerIndex;
+	std::lock_guard<std::mutex> lock(queue->mutex);
+	if (queue->head == queue->tail)
+	{
+		return false;
+	}
+
+	*taskIndex = queue->tasks[queue->head++];
+	return true;
+}
+
+bool b2TaskPool::StealTask(int32 workerIndex, int32* taskIndex)
+{
+	// Steal from the back of the queue, away from where its owner is working.
+	for (int32 i = 1; i < m_workerCount; ++i)
+	{
+		b2TaskQueue* queue = m_queues + (workerIndex + i) % m_workerCount;
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		if (queue->head < queue->tail)
+		{
+			*taskIndex = queue->tasks[--queue->tail];
+			return true;
+		}
+	}
+
+	return false;
+}
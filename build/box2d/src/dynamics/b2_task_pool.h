@@ -0,0 +1,86 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_TASK_POOL_H
+#define B2_TASK_POOL_H
+
+#include "box2d/b2_settings.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/// Callback for one task of a b2TaskPool::Run call.
+/// @param taskIndex the task to run, in [0, taskCount)
+/// @param workerIndex the worker running the task, in [0, workerCount). Worker 0 is the calling thread.
+/// @param context the user data passed to Run
+typedef void b2TaskCallback(int32 taskIndex, int32 workerIndex, void* context);
+
+/// This is an internal class.
+/// A fixed set of worker threads that run batches of independent tasks. Each worker
+/// has its own queue and takes work from the front of it, then steals from the back
+/// of the other queues when it runs dry. The thread calling Run is worker 0.
+class b2TaskPool
+{
+public:
+	/// Start workerCount - 1 threads.
+	b2TaskPool(int32 workerCount);
+	~b2TaskPool();
+
+	/// Run taskCount tasks and return when they have all finished. Tasks may run in any
+	/// order and on any worker, so they must not write to shared data.
+	void Run(int32 taskCount, b2TaskCallback* callback, void* context);
+
+	int32 GetWorkerCount() const { return m_workerCount; }
+
+private:
+
+	struct b2TaskQueue
+	{
+		std::mutex mutex;
+		int32* tasks;
+		int32 head;
+		int32 tail;
+	};
+
+	void WorkerMain(int32 workerIndex);
+	void RunTasks(int32 workerIndex);
+	bool PopTask(int32 workerIndex, int32* taskIndex);
+	bool StealTask(int32 workerIndex, int32* taskIndex);
+
+	int32 m_workerCount;
+	b2TaskQueue* m_queues;
+	int32 m_queueCapacity;
+	std::thread* m_threads;
+
+	b2TaskCallback* m_callback;
+	void* m_context;
+
+	std::mutex m_mutex;
+	std::condition_variable m_startCondition;
+	std::condition_variable m_finishCondition;
+	uint32 m_generation;
+	int32 m_activeWorkers;
+	bool m_exit;
+};
+
+#endif
@@ -22,6 +22,7 @@
 
 #include "b2_contact_solver.h"
 #include "b2_island.h"
+#include "b2_task_pool.h"
 
 #include "box2d/b2_body.h"
 #include "box2d/b2_broad_phase.h"
@@ -68,6 +69,10 @@ b2World::b2World(const b2Vec2& gravity)
 
 	m_contactManager.m_allocator = &m_blockAllocator;
 
+	m_solverThreadCount = 1;
+	m_taskPool = nullptr;
+	m_workerAllocators = nullptr;
+
 	memset(&m_profile, 0, sizeof(b2Profile));
 }
 
@@ -90,6 +95,8 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	SetSolverThreadCount(1);
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -390,170 +397,225 @@ void b2World::SetAllowSleeping(bool flag)
 	}
 }
 
-// Find islands, integrate and solve constraints, solve position constraints
-void b2World::Solve(const b2TimeStep& step)
+void b2World::SetSolverThreadCount(int32 count)
 {
-	m_profile.solveInit = 0.0f;
-	m_profile.solveVelocity = 0.0f;
-	m_profile.solvePosition = 0.0f;
-
-	// Size the island for the worst case.
-	b2Island island(m_bodyCount,
-					m_contactManager.m_contactCount,
-					m_jointCount,
-					&m_stackAllocator,
-					m_contactManager.m_contactListener);
-
-	// Clear all the island flags.
-	for (b2Body* b = m_bodyList; b; b = b->m_next)
-	{
-		b->m_flags &= ~b2Body::e_islandFlag;
-	}
-	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
-	{
-		c->m_flags &= ~b2Contact::e_islandFlag;
-	}
-	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	b2Assert(IsLocked() == false);
+	b2Assert(count >= 1);
+	if (IsLocked() || count == m_solverThreadCount)
 	{
-		j->m_islandFlag = false;
+		return;
 	}
 
-	// Build and simulate all awake islands.
-	int32 stackSize = m_bodyCount;
-	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
-	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	if (m_taskPool != nullptr)
 	{
-		if (seed->m_flags & b2Body::e_islandFlag)
+		m_taskPool->~b2TaskPool();
+		b2Free(m_taskPool);
+		m_taskPool = nullptr;
+
+		for (int32 i = 0; i < m_solverThreadCount - 1; ++i)
 		{
-			continue;
+			m_workerAllocators[i].~b2StackAllocator();
 		}
+		b2Free(m_workerAllocators);
+		m_workerAllocators = nullptr;
+	}
 
-		if (seed->IsAwake() == false || seed->IsEnabled() == false)
+	m_solverThreadCount = b2Max(count, 1);
+
+	if (m_solverThreadCount > 1)
+	{
+		void* mem = b2Alloc(sizeof(b2TaskPool));
+		m_taskPool = new (mem) b2TaskPool(m_solverThreadCount);
+
+		m_workerAllocators = (b2StackAllocator*)b2Alloc((m_solverThreadCount - 1) * sizeof(b2StackAllocator));
+		for (int32 i = 0; i < m_solverThreadCount - 1; ++i)
 		{
-			continue;
+			new (m_workerAllocators + i) b2StackAllocator;
 		}
+	}
+}
 
-		// The seed can be dynamic or kinematic.
-		if (seed->GetType() == b2_staticBody)
+// Add the seed and everything connected to it by contacts and joints to the island.
+void b2World::BuildIsland(b2Island* island, b2Body* seed, b2Body** stack, int32 stackSize)
+{
+	B2_NOT_USED(stackSize);
+
+	int32 stackCount = 0;
+	stack[stackCount++] = seed;
+	seed->m_flags |= b2Body::e_islandFlag;
+
+	// Perform a depth first search (DFS) on the constraint graph.
+	while (stackCount > 0)
+	{
+		// Grab the next body off the stack and add it to the island.
+		b2Body* b = stack[--stackCount];
+		b2Assert(b->IsEnabled() == true);
+		island->Add(b);
+
+		// Make sure the body is awake (without resetting sleep timer).
+		b->m_flags |= b2Body::e_awakeFlag;
+
+		// To keep islands as small as possible, we don't
+		// propagate islands across static bodies.
+		if (b->GetType() == b2_staticBody)
 		{
 			continue;
 		}
 
-		// Reset island and stack.
-		island.Clear();
-		int32 stackCount = 0;
-		stack[stackCount++] = seed;
-		seed->m_flags |= b2Body::e_islandFlag;
-
-		// Perform a depth first search (DFS) on the constraint graph.
-		while (stackCount > 0)
+		// Search all contacts connected to this body.
+		for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
 		{
-			// Grab the next body off the stack and add it to the island.
-			b2Body* b = stack[--stackCount];
-			b2Assert(b->IsEnabled() == true);
-			island.Add(b);
+			b2Contact* contact = ce->contact;
 
-			// Make sure the body is awake (without resetting sleep timer).
-			b->m_flags |= b2Body::e_awakeFlag;
+			// Has this contact already been added to an island?
+			if (contact->m_flags & b2Contact::e_islandFlag)
+			{
+				continue;
+			}
 
-			// To keep islands as small as possible, we don't
-			// propagate islands across static bodies.
-			if (b->GetType() == b2_staticBody)
+			// Is this contact solid and touching?
+			if (contact->IsEnabled() == false ||
+				contact->IsTouching() == false)
 			{
 				continue;
 			}
 
-			// Search all contacts connected to this body.
-			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+			// Skip sensors.
+			bool sensorA = contact->m_fixtureA->m_isSensor;
+			bool sensorB = contact->m_fixtureB->m_isSensor;
+			if (sensorA || sensorB)
 			{
-				b2Contact* contact = ce->contact;
+				continue;
+			}
 
-				// Has this contact already been added to an island?
-				if (contact->m_flags & b2Contact::e_islandFlag)
-				{
-					continue;
-				}
+			island->Add(contact);
+			contact->m_flags |= b2Contact::e_islandFlag;
 
-				// Is this contact solid and touching?
-				if (contact->IsEnabled() == false ||
-					contact->IsTouching() == false)
-				{
-					continue;
-				}
+			b2Body* other = ce->other;
 
-				// Skip sensors.
-				bool sensorA = contact->m_fixtureA->m_isSensor;
-				bool sensorB = contact->m_fixtureB->m_isSensor;
-				if (sensorA || sensorB)
-				{
-					continue;
-				}
+			// Was the other body already added to this island?
+			if (other->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
 
-				island.Add(contact);
-				contact->m_flags |= b2Contact::e_islandFlag;
+			b2Assert(stackCount < stackSize);
+			stack[stackCount++] = other;
+			other->m_flags |= b2Body::e_islandFlag;
+		}
 
-				b2Body* other = ce->other;
+		// Search all joints connect to this body.
+		for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+		{
+			if (je->joint->m_islandFlag == true)
+			{
+				continue;
+			}
 
-				// Was the other body already added to this island?
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
+			b2Body* other = je->other;
 
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
+			// Don't simulate joints connected to diabled bodies.
+			if (other->IsEnabled() == false)
+			{
+				continue;
 			}
 
-			// Search all joints connect to this body.
-			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+			island->Add(je->joint);
+			je->joint->m_islandFlag = true;
+
+			if (other->m_flags & b2Body::e_islandFlag)
 			{
-				if (je->joint->m_islandFlag == true)
-				{
-					continue;
-				}
+				continue;
+			}
 
-				b2Body* other = je->other;
+			b2Assert(stackCount < stackSize);
+			stack[stackCount++] = other;
+			other->m_flags |= b2Body::e_islandFlag;
+		}
+	}
+}
 
-				// Don't simulate joints connected to diabled bodies.
-				if (other->IsEnabled() == false)
-				{
-					continue;
-				}
+// Find islands, integrate and solve constraints, solve position constraints
+void b2World::Solve(const b2TimeStep& step)
+{
+	B2_PROFILE_ZONE("b2World::Solve");
 
-				island.Add(je->joint);
-				je->joint->m_islandFlag = true;
+	m_profile.solveInit = 0.0f;
+	m_profile.solveVelocity = 0.0f;
+	m_profile.solvePosition = 0.0f;
 
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
+	// Clear all the island flags.
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b->m_flags &= ~b2Body::e_islandFlag;
+	}
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		c->m_flags &= ~b2Contact::e_islandFlag;
+	}
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		j->m_islandFlag = false;
+	}
 
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
+	if (m_taskPool != nullptr)
+	{
+		SolveParallel(step);
+	}
+	else
+	{
+		// Size the island for the worst case.
+		b2Island island(m_bodyCount,
+						m_contactManager.m_contactCount,
+						m_jointCount,
+						&m_stackAllocator,
+						m_contactManager.m_contactListener);
+
+		// Build and simulate all awake islands.
+		int32 stackSize = m_bodyCount;
+		b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+		for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+		{
+			if (seed->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
+
+			if (seed->IsAwake() == false || seed->IsEnabled() == false)
+			{
+				continue;
 			}
-		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+			// The seed can be dynamic or kinematic.
+			if (seed->GetType() == b2_staticBody)
+			{
+				continue;
+			}
 
-		// Post solve cleanup.
-		for (int32 i = 0; i < island.m_bodyCount; ++i)
-		{
-			// Allow static bodies to participate in other islands.
-			b2Body* b = island.m_bodies[i];
-			if (b->GetType() == b2_staticBody)
+			// Reset island and stack.
+			island.Clear();
+			BuildIsland(&island, seed, stack, stackSize);
+
+			b2Profile profile;
+			island.Solve(&profile, step, m_gravity, m_allowSleep);
+			m_profile.solveInit += profile.solveInit;
+			m_profile.solveVelocity += profile.solveVelocity;
+			m_profile.solvePosition += profile.solvePosition;
+
+			// Post solve cleanup.
+			for (int32 i = 0; i < island.m_bodyCount; ++i)
 			{
-				b->m_flags &= ~b2Body::e_islandFlag;
+				// Allow static bodies to participate in other islands.
+				b2Body* b = island.m_bodies[i];
+				if (b->GetType() == b2_staticBody)
+				{
+					b->m_flags &= ~b2Body::e_islandFlag;
+				}
 			}
 		}
-	}
 
-	m_stackAllocator.Free(stack);
+		m_stackAllocator.Free(stack);
+	}
 
 	{
 		b2Timer timer;
@@ -581,9 +643,241 @@ void b2World::Solve(const b2TimeStep& step)
 	}
 }
 
+// An island found by b2World::SolveParallel. The bodies, contacts and joints are
+// ranges of the builder island, which holds all of the islands back to back.
+struct b2IslandRange
+{
+	int32 bodyStart;
+	int32 bodyCount;
+	int32 contactStart;
+	int32 contactCount;
+	int32 jointStart;
+	int32 jointCount;
+	b2Profile profile;
+	bool sleep;
+};
+
+struct b2IslandSolveContext
+{
+	b2TimeStep step;
+	b2Vec2 gravity;
+	bool allowSleep;
+	const b2Island* builder;
+	b2IslandRange* ranges;
+	const int32* tasks;
+	const int32* contactIndices;
+	b2ContactImpulse* impulses;
+	b2StackAllocator* mainAllocator;
+	b2StackAllocator* workerAllocators;
+};
+
+// Solve one island. This only writes to the island's own bodies and contacts, and to its range.
+static void b2SolveIslandRange(const b2IslandSolveContext* context, b2IslandRange* range, b2StackAllocator* allocator)
+{
+	const b2Island* builder = context->builder;
+	b2Island island(range->bodyCount, range->contactCount, range->jointCount, allocator, nullptr);
+
+	if (range->jointCount > 0)
+	{
+		// Joints find their bodies through b2Body::m_islandIndex, which Add sets. A static
+		// body can be in more than one island, so these islands are solved on the main thread.
+		for (int32 i = 0; i < range->bodyCount; ++i)
+		{
+			island.Add(builder->m_bodies[range->bodyStart + i]);
+		}
+		for (int32 i = 0; i < range->jointCount; ++i)
+		{
+			island.Add(builder->m_joints[range->jointStart + i]);
+		}
+	}
+	else
+	{
+		memcpy(island.m_bodies, builder->m_bodies + range->bodyStart, range->bodyCount * sizeof(b2Body*));
+		island.m_bodyCount = range->bodyCount;
+	}
+
+	memcpy(island.m_contacts, builder->m_contacts + range->contactStart, range->contactCount * sizeof(b2Contact*));
+	island.m_contactCount = range->contactCount;
+	island.m_contactIndices = context->contactIndices + 2 * range->contactStart;
+	if (context->impulses != nullptr)
+	{
+		island.m_impulses = context->impulses + range->contactStart;
+	}
+	island.m_deferSleep = true;
+
+	island.Solve(&range->profile, context->step, context->gravity, context->allowSleep);
+	range->sleep = island.m_sleep;
+}
+
+static void b2SolveIslandTask(int32 taskIndex, int32 workerIndex, void* userData)
+{
+	const b2IslandSolveContext* context = (const b2IslandSolveContext*)userData;
+	b2IslandRange* range = context->ranges + context->tasks[taskIndex];
+	b2StackAllocator* allocator = workerIndex == 0 ? context->mainAllocator : context->workerAllocators + workerIndex - 1;
+	b2SolveIslandRange(context, range, allocator);
+}
+
+// Find islands in the same order as Solve and solve the ones without joints on the task pool.
+// Anything islands can share (static body flags, the contact listener and the profile) is
+// updated afterwards in island order, so the results match the single threaded solver exactly.
+void b2World::SolveParallel(const b2TimeStep& step)
+{
+	B2_PROFILE_ZONE("b2World::SolveParallel");
+
+	int32 contactCount = m_contactManager.m_contactCount;
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+
+	// The builder holds every island back to back. A static body is added again for each
+	// island it touches, which takes a contact or joint, so this is the worst case.
+	b2Island builder(m_bodyCount + contactCount + m_jointCount,
+					 contactCount,
+					 m_jointCount,
+					 &m_stackAllocator,
+					 nullptr);
+
+	// Every island has at least one non-static body.
+	int32 stackSize = m_bodyCount;
+	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+	b2IslandRange* ranges = (b2IslandRange*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRange));
+	int32* tasks = (int32*)m_stackAllocator.Allocate(m_bodyCount * sizeof(int32));
+	int32* contactIndices = (int32*)m_stackAllocator.Allocate(2 * contactCount * sizeof(int32));
+	b2ContactImpulse* impulses = nullptr;
+	if (listener != nullptr)
+	{
+		impulses = (b2ContactImpulse*)m_stackAllocator.Allocate(contactCount * sizeof(b2ContactImpulse));
+	}
+
+	// Find all awake islands.
+	int32 islandCount = 0;
+	int32 taskCount = 0;
+	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	{
+		if (seed->m_flags & b2Body::e_islandFlag)
+		{
+			continue;
+		}
+
+		if (seed->IsAwake() == false || seed->IsEnabled() == false)
+		{
+			continue;
+		}
+
+		// The seed can be dynamic or kinematic.
+		if (seed->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		b2IslandRange* range = ranges + islandCount;
+		range->bodyStart = builder.m_bodyCount;
+		range->contactStart = builder.m_contactCount;
+		range->jointStart = builder.m_jointCount;
+
+		BuildIsland(&builder, seed, stack, stackSize);
+
+		range->bodyCount = builder.m_bodyCount - range->bodyStart;
+		range->contactCount = builder.m_contactCount - range->contactStart;
+		range->jointCount = builder.m_jointCount - range->jointStart;
+		range->sleep = false;
+
+		// Record where each contact's bodies are in the island now, before a shared
+		// static body is added to a later island and its m_islandIndex changes.
+		for (int32 i = range->contactStart; i < builder.m_contactCount; ++i)
+		{
+			b2Contact* contact = builder.m_contacts[i];
+			contactIndices[2 * i + 0] = contact->m_fixtureA->m_body->m_islandIndex - range->bodyStart;
+			contactIndices[2 * i + 1] = contact->m_fixtureB->m_body->m_islandIndex - range->bodyStart;
+		}
+
+		// Allow static bodies to participate in other islands.
+		for (int32 i = range->bodyStart; i < builder.m_bodyCount; ++i)
+		{
+			b2Body* b = builder.m_bodies[i];
+			if (b->GetType() == b2_staticBody)
+			{
+				b->m_flags &= ~b2Body::e_islandFlag;
+			}
+		}
+
+		if (range->jointCount == 0)
+		{
+			tasks[taskCount++] = islandCount;
+		}
+
+		++islandCount;
+	}
+
+	b2IslandSolveContext context;
+	context.step = step;
+	context.gravity = m_gravity;
+	context.allowSleep = m_allowSleep;
+	context.builder = &builder;
+	context.ranges = ranges;
+	context.tasks = tasks;
+	context.contactIndices = contactIndices;
+	context.impulses = impulses;
+	context.mainAllocator = &m_stackAllocator;
+	context.workerAllocators = m_workerAllocators;
+
+	m_taskPool->Run(taskCount, b2SolveIslandTask, &context);
+
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		if (ranges[i].jointCount > 0)
+		{
+			b2SolveIslandRange(&context, ranges + i, &m_stackAllocator);
+		}
+	}
+
+	// Apply the deferred results in the order the single threaded solver would have.
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		const b2IslandRange* range = ranges + i;
+		b2Body** bodies = builder.m_bodies + range->bodyStart;
+
+		m_profile.solveInit += range->profile.solveInit;
+		m_profile.solveVelocity += range->profile.solveVelocity;
+		m_profile.solvePosition += range->profile.solvePosition;
+
+		// A static body in several islands was woken by each of them and is
+		// left asleep only if the last one went to sleep.
+		for (int32 j = 0; j < range->bodyCount; ++j)
+		{
+			bodies[j]->m_flags |= b2Body::e_awakeFlag;
+		}
+
+		if (listener != nullptr)
+		{
+			for (int32 j = range->contactStart; j < range->contactStart + range->contactCount; ++j)
+			{
+				listener->PostSolve(builder.m_contacts[j], impulses + j);
+			}
+		}
+
+		if (range->sleep)
+		{
+			for (int32 j = 0; j < range->bodyCount; ++j)
+			{
+				bodies[j]->SetAwake(false);
+			}
+		}
+	}
+
+	if (impulses != nullptr)
+	{
+		m_stackAllocator.Free(impulses);
+	}
+	m_stackAllocator.Free(contactIndices);
+	m_stackAllocator.Free(tasks);
+	m_stackAllocator.Free(ranges);
+	m_stackAllocator.Free(stack);
+}
+
 // Find TOI contacts and solve them.
 void b2World::SolveTOI(const b2TimeStep& step)
 {
+	B2_PROFILE_ZONE("b2World::SolveTOI");
+
 	b2Island island(2 * b2_maxTOIContacts, b2_maxTOIContacts, 0, &m_stackAllocator, m_contactManager.m_contactListener);
 
 	if (m_stepComplete)
@@ -904,6 +1198,7 @@ void b2World::SolveTOI(const b2TimeStep& step)
 
 void b2World::Step(float dt, int32 velocityIterations, int32 positionIterations)
 {
+	B2_PROFILE_ZONE("b2World::Step");
 	b2Timer stepTimer;
 
 	// If new fixtures were added, we need to find the new contacts.
@@ -934,6 +1229,7 @@ void b2World::Step(float dt, int32 velocityIterations, int32 positionIterations)
 	
 	// Update contacts. This is where some contacts are destroyed.
 	{
+		B2_PROFILE_ZONE("b2ContactManager::Collide");
 		b2Timer timer;
 		m_contactManager.Collide();
 		m_profile.collide = timer.GetMilliseconds();
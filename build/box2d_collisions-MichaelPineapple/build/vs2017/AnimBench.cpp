@@ -0,0 +1,289 @@
+#include <animation/animation.h>
+#include <animation/skeleton.h>
+#include <animation/compiled_clip.h>
+#include <system/string_id.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+using std::vector;
+using namespace gef;
+
+/* Benchmark for skeletal animation playback.
+
+Builds a random skeleton and two random animations, then plays them on a crowd of characters, blending half of them
+between the two animations. Each frame is evaluated the old way with SkeletonPose::SetPoseFromAnim and Linear2PoseBlend,
+then with compiled clips through a ClipBatch on an increasing number of threads.
+Checks that every local and global joint pose is exactly the same both ways. Returns 1 if any do not match.
+
+Usage: anim_bench [seed] [characters] [joints] [keys] [frames] [threads]
+*/
+
+/* Return a random float between two values
+
+_min - Lowest value
+_max - Highest value
+*/
+float randomFloat(float _min, float _max)
+{
+	return _min + (_max - _min) * ((float)rand() / (float)RAND_MAX);
+}
+
+/* Return a random unit quaternion */
+Quaternion randomRotation()
+{
+	Quaternion rotation(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f));
+	rotation.Normalise();
+	return rotation;
+}
+
+/* Build a skeleton with random parents and bind poses
+
+_skeleton - Skeleton to add the joints to
+_numJoints - Number of joints
+*/
+void buildSkeleton(Skeleton& _skeleton, int _numJoints)
+{
+	vector<Matrix44> globalBind(_numJoints);
+	for (int j = 0; j < _numJoints; j++)
+	{
+		JointPose local;
+		local.set_rotation(randomRotation());
+		local.set_translation(Vector4(randomFloat(-1.0f, 1.0f), randomFloat(0.0f, 2.0f), randomFloat(-1.0f, 1.0f)));
+		local.set_scale(Vector4(1.0f, 1.0f, 1.0f));
+
+		// parents always come before their children
+		Joint joint;
+		joint.name_id = GetStringId("joint" + std::to_string(j));
+		joint.parent = j == 0 ? -1 : rand() % j;
+		globalBind[j] = joint.parent == -1 ? local.GetMatrix() : local.GetMatrix() * globalBind[joint.parent];
+		joint.inv_bind_pose.Inverse(globalBind[j]);
+		_skeleton.AddJoint(joint);
+	}
+}
+
+/* Build an animation with random keys for most of the joints of a skeleton
+
+_animation - Animation to add the nodes to
+_skeleton - Skeleton the animation is for
+_numKeys - Most keys in a track
+_duration - Time of the last key
+*/
+void buildAnimation(Animation& _animation, const Skeleton& _skeleton, int _numKeys, float _duration)
+{
+	for (int j = 0; j < _skeleton.joint_count(); j++)
+	{
+		// leave some joints in the bind pose
+		if (j % 8 == 7) continue;
+
+		TransformAnimNode* node = new TransformAnimNode();
+		node->set_name_id(_skeleton.joint(j).name_id);
+
+		// tracks have different numbers of keys, some have none or one
+		int numRotationKeys = j % 11 == 5 ? 0 : 1 + rand() % _numKeys;
+		for (int k = 0; k < numRotationKeys; k++)
+		{
+			QuaternionKey key;
+			key.time = numRotationKeys == 1 ? 0.0f : _duration * k / (numRotationKeys - 1);
+			key.value = randomRotation();
+			node->rotation_keys().push_back(key);
+		}
+
+		int numTranslationKeys = j % 5 == 2 ? 0 : 1 + rand() % _numKeys;
+		for (int k = 0; k < numTranslationKeys; k++)
+		{
+			Vector3Key key;
+			key.time = numTranslationKeys == 1 ? 0.0f : _duration * k / (numTranslationKeys - 1);
+			key.value = Vector4(randomFloat(-1.0f, 1.0f), randomFloat(0.0f, 2.0f), randomFloat(-1.0f, 1.0f));
+			node->translation_keys().push_back(key);
+		}
+
+		_animation.AddNode(node);
+	}
+	_animation.CalculateDuration();
+}
+
+/* One character playing the animations */
+struct Character
+{
+	float timeOffset;
+	float blendWeight;
+	bool blend;
+	SkeletonPose pose;
+	SkeletonPose blendPose;
+	ClipCursor cursor;
+	ClipCursor blendCursor;
+};
+
+/* Return the time a character is at in a looping animation
+
+_character - Character playing the animation
+_frame - Frame number
+_duration - Length of the animation
+*/
+float playTime(const Character& _character, int _frame, float _duration)
+{
+	return fmodf(_character.timeOffset + _frame / 60.0f, _duration);
+}
+
+/* Return if two poses have exactly the same local and global joint transforms
+
+_a - First pose
+_b - Second pose
+*/
+bool posesMatch(const SkeletonPose& _a, const SkeletonPose& _b)
+{
+	for (size_t j = 0; j < _a.local_pose().size(); j++)
+	{
+		const JointPose& a = _a.local_pose()[j];
+		const JointPose& b = _b.local_pose()[j];
+		if (a.rotation().x != b.rotation().x || a.rotation().y != b.rotation().y || a.rotation().z != b.rotation().z || a.rotation().w != b.rotation().w) return false;
+		// blending leaves the w of translations uninitialised, so only compare x, y and z
+		if (memcmp(a.translation().float_ptr(), b.translation().float_ptr(), sizeof(float) * 3) != 0) return false;
+		if (memcmp(a.scale().float_ptr(), b.scale().float_ptr(), sizeof(float) * 3) != 0) return false;
+		if (memcmp(_a.global_pose()[j].float_ptr(), _b.global_pose()[j].float_ptr(), sizeof(float) * 16) != 0) return false;
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	// read the benchmark settings from the command line
+	unsigned int seed = argc > 1 ? (unsigned int)atoi(argv[1]) : 1;
+	int numCharacters = argc > 2 ? atoi(argv[2]) : 500;
+	int numJoints = argc > 3 ? atoi(argv[3]) : 64;
+	int numKeys = argc > 4 ? atoi(argv[4]) : 60;
+	int numFrames = argc > 5 ? atoi(argv[5]) : 120;
+	int maxThreads = argc > 6 ? atoi(argv[6]) : (int)std::thread::hardware_concurrency();
+	if (maxThreads < 1) maxThreads = 1;
+	srand(seed);
+
+	printf("anim_bench seed=%u characters=%d joints=%d keys=%d frames=%d threads=%d\n", seed, numCharacters, numJoints, numKeys, numFrames, maxThreads);
+
+	Skeleton skeleton;
+	buildSkeleton(skeleton, numJoints);
+	SkeletonPose bindPose;
+	bindPose.CreateBindPose(&skeleton);
+
+	Animation walk, run;
+	buildAnimation(walk, skeleton, numKeys, 2.0f);
+	buildAnimation(run, skeleton, numKeys / 2 + 1, 1.2f);
+
+	CompiledClip walkClip, runClip;
+	walkClip.Compile(walk, bindPose);
+	runClip.Compile(run, bindPose);
+	printf("compiled %d + %d keys\n", walkClip.key_count(), runClip.key_count());
+
+	vector<Character> characters(numCharacters);
+	vector<Character> reference(numCharacters);
+	for (int i = 0; i < numCharacters; i++)
+	{
+		reference[i].timeOffset = characters[i].timeOffset = randomFloat(0.0f, 2.0f);
+		reference[i].blendWeight = characters[i].blendWeight = randomFloat(0.0f, 1.0f);
+		reference[i].blend = characters[i].blend = i % 2 == 1;
+		characters[i].pose.CreateBindPose(&skeleton);
+		reference[i].pose.CreateBindPose(&skeleton);
+		reference[i].blendPose.CreateBindPose(&skeleton);
+	}
+
+	// evaluate a frame the old way
+	SkeletonPose walkPose, runPose;
+	walkPose.CreateBindPose(&skeleton);
+	runPose.CreateBindPose(&skeleton);
+	auto referenceFrame = [&](int _frame)
+	{
+		for (int i = 0; i < numCharacters; i++)
+		{
+			Character& character = reference[i];
+			if (character.blend)
+			{
+				walkPose.SetPoseFromAnim(walk, bindPose, playTime(character, _frame, walk.duration()), false);
+				runPose.SetPoseFromAnim(run, bindPose, playTime(character, _frame, run.duration()), false);
+				character.pose.Linear2PoseBlend(walkPose, runPose, character.blendWeight);
+			}
+			else
+				character.pose.SetPoseFromAnim(walk, bindPose, playTime(character, _frame, walk.duration()));
+		}
+	};
+
+	// evaluate a frame with compiled clips
+	vector<ClipEvaluation> evaluations(numCharacters);
+	for (int i = 0; i < numCharacters; i++)
+	{
+		evaluations[i].pose = &characters[i].pose;
+		evaluations[i].clip = &walkClip;
+		evaluations[i].cursor = &characters[i].cursor;
+		if (characters[i].blend)
+		{
+			evaluations[i].blend_clip = &runClip;
+			evaluations[i].blend_cursor = &characters[i].blendCursor;
+			evaluations[i].blend_weight = characters[i].blendWeight;
+		}
+	}
+	auto compiledFrame = [&](ClipBatch& _batch, int _frame)
+	{
+		for (int i = 0; i < numCharacters; i++)
+		{
+			evaluations[i].time = playTime(characters[i], _frame, walkClip.duration());
+			evaluations[i].blend_time = playTime(characters[i], _frame, runClip.duration());
+		}
+		_batch.Evaluate(numCharacters > 0 ? &evaluations[0] : NULL, numCharacters);
+	};
+
+	// check every frame, the clips loop so the cursors go backwards as well as forwards
+	bool allMatch = true;
+	{
+		ClipBatch batch(maxThreads);
+		int mismatches = 0;
+		for (int frame = 0; frame < numFrames; frame++)
+		{
+			referenceFrame(frame);
+			compiledFrame(batch, frame);
+			for (int i = 0; i < numCharacters; i++)
+				if (!posesMatch(reference[i].pose, characters[i].pose)) mismatches++;
+		}
+		allMatch = mismatches == 0;
+		printf("%-24s %d mismatched poses  %s\n", "check", mismatches, allMatch ? "ok" : "MISMATCH");
+	}
+
+	// time the old way
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	for (int frame = 0; frame < numFrames; frame++) referenceFrame(frame);
+	double referenceMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / numFrames;
+	printf("%-24s %9.4f ms/frame\n", "SetPoseFromAnim", referenceMs);
+
+	// time compiled clips on more and more threads
+	vector<int> threadCounts;
+	for (int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+	threadCounts.push_back(maxThreads);
+	for (size_t t = 0; t < threadCounts.size(); t++)
+	{
+		int threads = threadCounts[t];
+		ClipBatch batch(threads);
+		for (int i = 0; i < numCharacters; i++)
+		{
+			characters[i].cursor.Reset();
+			characters[i].blendCursor.Reset();
+		}
+
+		start = std::chrono::high_resolution_clock::now();
+		for (int frame = 0; frame < numFrames; frame++) compiledFrame(batch, frame);
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / numFrames;
+
+		// the last frame must still match
+		int mismatches = 0;
+		for (int i = 0; i < numCharacters; i++)
+			if (!posesMatch(reference[i].pose, characters[i].pose)) mismatches++;
+		allMatch &= mismatches == 0;
+
+		printf("ClipBatch %2d thread%s     %9.4f ms/frame  speedup %5.2fx  %s\n", threads, threads == 1 ? " " : "s",
+			ms, ms > 0.0 ? referenceMs / ms : 0.0, mismatches == 0 ? "ok" : "MISMATCH");
+	}
+
+	if (!allMatch) printf("FAILED: compiled clips and SetPoseFromAnim do not match\n");
+	return allMatch ? 0 : 1;
+}
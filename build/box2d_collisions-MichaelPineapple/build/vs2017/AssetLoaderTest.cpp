@@ -0,0 +1,278 @@
+#include <assets/asset_loader.h>
+#include <graphics/scene.h>
+#include <graphics/scene_cache.h>
+#include <graphics/mesh_data.h>
+#include <graphics/mesh.h>
+#include <graphics/material.h>
+#include <graphics/font.h>
+#include <graphics/texture.h>
+#include <system/string_id.h>
+#include <platform/null/system/platform_null.h>
+#include <png.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+using std::vector;
+using namespace gef;
+
+/* Test for the background asset loader.
+
+Writes a texture, a font and a scene using that texture, then loads them along with files that don't exist through an
+AssetLoader on the null platform. Update is polled until nothing is loading, and every request must end up ready or
+failed as expected. One request is released while it is still loading, and a second loader is destroyed with requests
+still pending. Everything is run once with worker threads and once with the decoding done in Update.
+Returns 1 if any check fails.
+
+Usage: asset_loader_test [directory]
+The test files are written to the directory, which defaults to the current one.
+*/
+
+static const int TEXTURE_SIZE = 4;
+
+// How long to poll Update before giving up on the requests
+static const int TIMEOUT_MS = 10000;
+
+// Number of checks which have failed
+static int failures = 0;
+
+/* Print a check's result and count it if it failed
+
+_passed - If the check passed
+_description - What was checked
+*/
+void check(bool _passed, const char* _description)
+{
+	printf("%-64s %s\n", _description, _passed ? "ok" : "FAILED");
+	if (!_passed) failures++;
+}
+
+/* Write a small RGBA PNG, returns if it was written
+
+_filename - File to write
+*/
+bool writePng(const std::string& _filename)
+{
+	FILE* file = fopen(_filename.c_str(), "wb");
+	if (!file) return false;
+
+	png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+	png_infop info = png ? png_create_info_struct(png) : NULL;
+	if (!png || !info || setjmp(png_jmpbuf(png)))
+	{
+		png_destroy_write_struct(&png, &info);
+		fclose(file);
+		return false;
+	}
+
+	// a checker pattern, so the image isn't all one colour
+	png_byte pixels[TEXTURE_SIZE][TEXTURE_SIZE * 4];
+	png_bytep rows[TEXTURE_SIZE];
+	for (int y = 0; y < TEXTURE_SIZE; y++)
+	{
+		for (int x = 0; x < TEXTURE_SIZE; x++)
+		{
+			png_byte value = ((x + y) % 2) ? 0xff : 0x00;
+			pixels[y][x * 4 + 0] = value;
+			pixels[y][x * 4 + 1] = value;
+			pixels[y][x * 4 + 2] = value;
+			pixels[y][x * 4 + 3] = 0xff;
+		}
+		rows[y] = pixels[y];
+	}
+
+	png_init_io(png, file);
+	png_set_IHDR(png, info, TEXTURE_SIZE, TEXTURE_SIZE, 8, PNG_COLOR_TYPE_RGB_ALPHA, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	png_write_info(png, info);
+	png_write_image(png, rows);
+	png_write_end(png, NULL);
+	png_destroy_write_struct(&png, &info);
+
+	fclose(file);
+	return true;
+}
+
+/* Write a font description with a single character, and its texture, returns if they were written
+
+_fontName - Name of the font, the files written are _fontName.fnt and _fontName_0.png
+*/
+bool writeFont(const std::string& _fontName)
+{
+	std::ofstream file((_fontName + ".fnt").c_str());
+	file << "info face=test size=4" << std::endl;
+	file << "common lineHeight=4 base=4 scaleW=" << TEXTURE_SIZE << " scaleH=" << TEXTURE_SIZE << " pages=1" << std::endl;
+	file << "chars count=1" << std::endl;
+	file << "char id=65 x=0 y=0 width=4 height=4 xoffset=0 yoffset=0 xadvance=4 page=0" << std::endl;
+	file.close();
+
+	return !file.fail() && writePng(_fontName + "_0.png");
+}
+
+/* Write a mapped scene with one mesh, using a texture, returns if it was written
+
+_platform - Platform to write the scene with
+_filename - File to write
+_textureFilename - Texture used by the scene's material
+*/
+bool writeScene(const Platform& _platform, const std::string& _filename, const std::string& _textureFilename)
+{
+	Scene scene;
+	scene.material_data.push_back(MaterialData());
+	scene.material_data.back().name_id = GetStringId("test_material");
+	scene.material_data.back().colour = 0xffffffff;
+	scene.material_data.back().diffuse_texture = _textureFilename;
+
+	scene.mesh_data.push_back(MeshData());
+	MeshData& mesh = scene.mesh_data.back();
+	mesh.name_id = GetStringId("test_mesh");
+	mesh.aabb.Update(Vector4(-1.0f, -1.0f, -1.0f));
+	mesh.aabb.Update(Vector4(1.0f, 1.0f, 1.0f));
+
+	mesh.vertex_data.num_vertices = 3;
+	mesh.vertex_data.vertex_byte_size = sizeof(Mesh::Vertex);
+	mesh.vertex_data.vertices = calloc(3, sizeof(Mesh::Vertex));
+
+	PrimitiveData* primitive = new PrimitiveData();
+	primitive->material_name_id = GetStringId("test_material");
+	primitive->type = TRIANGLE_LIST;
+	primitive->num_indices = 3;
+	primitive->index_byte_size = sizeof(UInt16);
+	primitive->indices = malloc(3 * sizeof(UInt16));
+	for (int i = 0; i < 3; i++) ((UInt16*)primitive->indices)[i] = (UInt16)i;
+	mesh.primitives.push_back(primitive);
+
+	return scene.WriteMappedSceneToFile(_platform, _filename.c_str());
+}
+
+/* Call Update until nothing is loading, returns false if that took too long
+
+_loader - The loader to poll
+*/
+bool pollUntilDone(AssetLoader& _loader)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while (_loader.Update() > 0)
+	{
+		if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(TIMEOUT_MS)) return false;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+
+/* Load every kind of asset, and some missing files, and check each request finishes the way it should
+
+_platform - Platform to load the assets with
+_directory - Directory the test files are in
+_workers - Number of worker threads for the loader, 0 to decode in Update
+*/
+void loadAssets(Platform& _platform, const std::string& _directory, int _workers)
+{
+	printf("%d workers\n", _workers);
+
+	SceneCache cache(_platform);
+	AssetLoader loader(_platform, _workers);
+
+	AssetRequest* texture = loader.LoadTexture((_directory + "asset_test_texture.png").c_str());
+	AssetRequest* font = loader.LoadFont((_directory + "asset_test_font").c_str());
+	AssetRequest* scene = loader.LoadScene(&cache, (_directory + "asset_test_scene.scn").c_str());
+	AssetRequest* missingTexture = loader.LoadTexture((_directory + "asset_test_missing.png").c_str());
+	AssetRequest* missingFont = loader.LoadFont((_directory + "asset_test_missing").c_str());
+	AssetRequest* missingScene = loader.LoadScene(&cache, (_directory + "asset_test_missing.scn").c_str());
+
+	// released before Update has had a chance to finish it, the loader deletes it once the worker is done with it
+	AssetRequest* released = loader.LoadTexture((_directory + "asset_test_texture.png").c_str());
+	check(!released->finished(), "request is loading until Update finishes it");
+	loader.Release(released);
+
+	check(pollUntilDone(loader), "every request finishes");
+	check(loader.num_loading() == 0, "nothing left loading");
+
+	check(texture->status() == ASSET_READY && texture->texture() != NULL, "texture is ready");
+	check(texture->width() == TEXTURE_SIZE && texture->height() == TEXTURE_SIZE, "texture has the size of the image");
+	check(font->status() == ASSET_READY && font->font() != NULL, "font is ready");
+	check(scene->status() == ASSET_READY && scene->scene() != NULL && scene->mesh() != NULL, "scene is ready with a mesh");
+
+	// the scene's texture was decoded on the worker and created by Update
+	bool sceneTextured = scene->scene() != NULL && scene->scene()->materials.size() == 1 && scene->scene()->materials.front()->texture() != NULL;
+	check(sceneTextured && scene->scene()->texture_images.empty(), "scene material has its texture");
+
+	check(missingTexture->status() == ASSET_FAILED && missingTexture->texture() == NULL, "missing texture failed");
+	check(missingFont->status() == ASSET_FAILED && missingFont->font() == NULL, "missing font failed");
+	check(missingScene->status() == ASSET_FAILED && missingScene->scene() == NULL, "missing scene failed");
+
+	// the released request is never finished, so it has no timing
+	check(loader.timings().size() == 6, "a timing for each request that wasn't released");
+
+	// a scene already in the cache, or already failed, is finished straight away
+	AssetRequest* cachedScene = loader.LoadScene(&cache, (_directory + "asset_test_scene.scn").c_str());
+	AssetRequest* cachedMissingScene = loader.LoadScene(&cache, (_directory + "asset_test_missing.scn").c_str());
+	check(cachedScene->status() == ASSET_READY && cachedScene->scene() == scene->scene(), "cached scene is ready straight away");
+	check(cachedMissingScene->status() == ASSET_FAILED, "cached missing scene fails straight away");
+
+	// ready textures and fonts belong to the caller
+	delete texture->texture();
+	delete font->font();
+
+	loader.Release(texture);
+	loader.Release(font);
+	loader.Release(scene);
+	loader.Release(missingTexture);
+	loader.Release(missingFont);
+	loader.Release(missingScene);
+	loader.Release(cachedScene);
+	loader.Release(cachedMissingScene);
+}
+
+/* Destroy a loader while its requests are still loading, some of them already released
+
+_platform - Platform to load the assets with
+_directory - Directory the test files are in
+_workers - Number of worker threads for the loader, 0 to decode in Update
+*/
+void destroyWhileLoading(Platform& _platform, const std::string& _directory, int _workers)
+{
+	SceneCache cache(_platform);
+	AssetLoader* loader = new AssetLoader(_platform, _workers);
+
+	for (int i = 0; i < 8; i++)
+	{
+		AssetRequest* texture = loader->LoadTexture((_directory + "asset_test_texture.png").c_str());
+		loader->LoadFont((_directory + "asset_test_font").c_str());
+		loader->LoadScene(&cache, (_directory + "asset_test_scene.scn").c_str());
+		if (i % 2) loader->Release(texture);
+	}
+
+	// anything not finished is thrown away, and nothing is left for the cache
+	delete loader;
+	check(cache.num_scenes() == 0, "destroying a loader with requests pending");
+}
+
+int main(int argc, char** argv)
+{
+	std::string directory = argc > 1 ? std::string(argv[1]) + "/" : std::string();
+
+	PlatformNull platform;
+
+	check(writePng(directory + "asset_test_texture.png"), "write texture");
+	check(writeFont(directory + "asset_test_font"), "write font");
+	check(writeScene(platform, directory + "asset_test_scene.scn", directory + "asset_test_texture.png"), "write scene");
+
+	int workerCounts[] = { 2, 0 };
+	for (int i = 0; i < 2; i++)
+	{
+		loadAssets(platform, directory, workerCounts[i]);
+		destroyWhileLoading(platform, directory, workerCounts[i]);
+	}
+
+	remove((directory + "asset_test_texture.png").c_str());
+	remove((directory + "asset_test_font.fnt").c_str());
+	remove((directory + "asset_test_font_0.png").c_str());
+	remove((directory + "asset_test_scene.scn").c_str());
+
+	printf("%s\n", failures == 0 ? "all checks passed" : "FAILED");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,296 @@
+#include "EntityStore.h"
+#include <graphics/mesh.h>
+#include <stdint.h>
+
+/* EntityStore constructor */
+EntityStore::EntityStore()
+{
+}
+
+/* EntityStore destructor, deletes all pooled objects and meshes */
+EntityStore::~EntityStore()
+{
+	release();
+}
+
+/* Return a MclObject from the pool, initialized with some creation info.
+The object is owned by the store once it has been added with 'add', and is recycled when it is removed or the store is cleared.
+
+_position - Starting position of the MclObject
+_size - Size of the MclObject
+_dynamic - If the MclObject should be affected by the Box2D physics
+_entityType - The type of entity this MclObject is.
+_mesh - Mesh of the MclObject
+_world - World to create the MclObject's body in
+*/
+MclObject* EntityStore::createObject(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType, Mesh* _mesh, b2World* _world)
+{
+	MclObject* obj;
+	if (freeObjects.empty()) obj = new MclObject();
+	else
+	{
+		obj = freeObjects.back();
+		freeObjects.pop_back();
+	}
+
+	obj->init(_position, _size, _dynamic, _entityType, _mesh, _world);
+	return obj;
+}
+
+/* Return a box mesh of the given size, building it only the first time that size is asked for.
+The mesh is owned by the store and is kept until the store is released.
+
+_size - Width and height of the box
+_builder - Builder used to create the mesh if it is not cached yet
+*/
+Mesh* EntityStore::getBoxMesh(b2Vec2 _size, PrimitiveBuilder* _builder)
+{
+	for (int i = 0; i < boxMeshes.size(); i++)
+	{
+		if (boxMeshSizes[i].x == _size.x && boxMeshSizes[i].y == _size.y) return boxMeshes[i];
+	}
+
+	Mesh* mesh = _builder->CreateBoxMesh(Vector4(_size.x / 2.0f, _size.y / 2.0f, 0.25f));
+	boxMeshSizes.push_back(_size);
+	boxMeshes.push_back(mesh);
+	return mesh;
+}
+
+/* Add a MclObject to the store and return a handle to it
+
+_obj - The MclObject to add.
+*/
+EntityHandle EntityStore::add(MclObject* _obj)
+{
+	// reuse a free handle slot if there is one
+	int slot;
+	if (freeSlots.empty())
+	{
+		slot = (int)slotIndices.size();
+		slotIndices.push_back(-1);
+		slotGenerations.push_back(0);
+	}
+	else
+	{
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+
+	// append the entity to the end of the packed arrays
+	int index = (int)objects.size();
+	b2Body* body = _obj->getBody();
+	bodies.push_back(body);
+	positions.push_back(b2Vec2_zero);
+	angles.push_back(0.0f);
+	types.push_back(_obj->getEntityType());
+	transforms.push_back(Matrix44());
+	objects.push_back(_obj);
+	slots.push_back(slot);
+	slotIndices[slot] = index;
+
+	// the body's user data holds the handle slot (offset by 1 so NULL still means "not an entity")
+	body->SetUserData((void*)(intptr_t)(slot + 1));
+
+	copyFromBody(index);
+
+	EntityHandle handle;
+	handle.slot = slot;
+	handle.generation = slotGenerations[slot];
+	return handle;
+}
+
+/* Remove an entity from the store, destroy its body and return its MclObject to the pool, does nothing if the handle is stale.
+The last entity is moved into the gap so the arrays stay packed.
+
+_handle - Handle of the entity to remove
+_world - World the entity's body belongs to
+*/
+void EntityStore::remove(EntityHandle _handle, b2World* _world)
+{
+	int index = indexOf(_handle);
+	if (index < 0) return;
+
+	b2Body* body = bodies[index];
+	MclObject* obj = objects[index];
+
+	// unregister the body first, so the contacts ended while it is destroyed are not seen as entity contacts
+	body->SetUserData(NULL);
+
+	// move the last entity into the removed entity's place
+	int last = (int)objects.size() - 1;
+	if (index != last)
+	{
+		bodies[index] = bodies[last];
+		positions[index] = positions[last];
+		angles[index] = angles[last];
+		types[index] = types[last];
+		transforms[index] = transforms[last];
+		objects[index] = objects[last];
+		slots[index] = slots[last];
+		slotIndices[slots[index]] = index;
+	}
+	bodies.pop_back();
+	positions.pop_back();
+	angles.pop_back();
+	types.pop_back();
+	transforms.pop_back();
+	objects.pop_back();
+	slots.pop_back();
+
+	// free the handle slot, bumping its generation so old handles become stale
+	slotIndices[_handle.slot] = -1;
+	slotGenerations[_handle.slot]++;
+	freeSlots.push_back(_handle.slot);
+
+	_world->DestroyBody(body);
+	obj->releaseBody();
+
+	// return the object to the pool
+	freeObjects.push_back(obj);
+}
+
+/* Copy the position, angle and world matrix of one entity from its body
+
+_index - Packed index of the entity
+*/
+void EntityStore::copyFromBody(int _index)
+{
+	const b2Transform& xf = bodies[_index]->GetTransform();
+	positions[_index] = xf.p;
+	angles[_index] = xf.q.GetAngle();
+
+	// rotation about Z followed by the translation, built straight from the body's sine and cosine
+	Matrix44& m = transforms[_index];
+	m.SetRow(0, Vector4(xf.q.c, xf.q.s, 0.0f, 0.0f));
+	m.SetRow(1, Vector4(-xf.q.s, xf.q.c, 0.0f, 0.0f));
+	m.SetRow(2, Vector4(0.0f, 0.0f, 1.0f, 0.0f));
+	m.SetRow(3, Vector4(xf.p.x, xf.p.y, 0.0f, 1.0f));
+}
+
+/* Copy body state into the position, angle and world matrix arrays for every entity.
+Called once after each world step. */
+void EntityStore::syncFromBodies()
+{
+	int count = (int)objects.size();
+	for (int i = 0; i < count; i++) copyFromBody(i);
+}
+
+/* Remove all entities and return every MclObject to the pool.
+Bodies are not destroyed here, the world is expected to be deleted along with them. */
+void EntityStore::clear()
+{
+	// every live entity's object goes back to the pool
+	freeObjects.insert(freeObjects.end(), objects.begin(), objects.end());
+
+	bodies.clear();
+	positions.clear();
+	angles.clear();
+	types.clear();
+	transforms.clear();
+	objects.clear();
+	slots.clear();
+
+	// every handle given out so far becomes stale
+	freeSlots.clear();
+	for (int i = (int)slotIndices.size() - 1; i >= 0; i--)
+	{
+		slotIndices[i] = -1;
+		slotGenerations[i]++;
+		freeSlots.push_back(i);
+	}
+}
+
+/* Clear the store and delete all pooled MclObjects and box meshes */
+void EntityStore::release()
+{
+	clear();
+
+	for (int i = 0; i < freeObjects.size(); i++) delete freeObjects[i];
+	freeObjects.clear();
+
+	for (int i = 0; i < boxMeshes.size(); i++) delete boxMeshes[i];
+	boxMeshes.clear();
+	boxMeshSizes.clear();
+}
+
+/* Return the number of live entities */
+int EntityStore::size() const
+{
+	return (int)objects.size();
+}
+
+/* Return if a handle still refers to a live entity
+
+_handle - The handle to check
+*/
+bool EntityStore::isValid(EntityHandle _handle) const
+{
+	return indexOf(_handle) >= 0;
+}
+
+/* Return the packed index of an entity, -1 if the handle is stale
+
+_handle - Handle of the entity
+*/
+int EntityStore::indexOf(EntityHandle _handle) const
+{
+	if (_handle.slot < 0 || _handle.slot >= slotIndices.size()) return -1;
+	if (slotGenerations[_handle.slot] != _handle.generation) return -1;
+	return slotIndices[_handle.slot];
+}
+
+/* Return the packed index of the entity which owns a body, -1 if the body is not an entity in this store
+
+_body - The Box2D body
+*/
+int EntityStore::indexOf(const b2Body* _body) const
+{
+	int slot = (int)(intptr_t)_body->GetUserData() - 1;
+	if (slot < 0 || slot >= slotIndices.size()) return -1;
+	return slotIndices[slot];
+}
+
+/* Return a handle to the entity at a packed index
+
+_index - Packed index of the entity, from 0 to size()-1
+*/
+EntityHandle EntityStore::handleOf(int _index) const
+{
+	EntityHandle handle;
+	handle.slot = slots[_index];
+	handle.generation = slotGenerations[handle.slot];
+	return handle;
+}
+
+/* Return the MclObject at a packed index
+
+_index - Packed index of the entity, from 0 to size()-1
+*/
+MclObject* EntityStore::getObject(int _index) const
+{
+	return objects[_index];
+}
+
+/* Return the positions of all live entities, as of the last sync */
+const b2Vec2* EntityStore::getPositions() const
+{
+	return positions.data();
+}
+
+/* Return the angles of all live entities, as of the last sync */
+const float* EntityStore::getAngles() const
+{
+	return angles.data();
+}
+
+/* Return the entity types of all live entities */
+const ObjectType* EntityStore::getTypes() const
+{
+	return types.data();
+}
+
+/* Return the world matrices of all live entities, as of the last sync */
+const Matrix44* EntityStore::getTransforms() const
+{
+	return transforms.data();
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <vector>
+#include <box2d/box2d.h>
+#include <maths/matrix44.h>
+#include <MclObject.h>
+using std::vector;
+using gef::Matrix44;
+
+/* EntityHandle struct, a stable reference to an entity within an 'EntityStore'.
+> Stays valid while other entities are added or removed, and becomes stale once its own entity is removed.
+*/
+struct EntityHandle
+{
+	int slot;
+	int generation;
+};
+
+/* EntityStore class, pooled structure-of-arrays storage for the entities in a simulation.
+> Live entities are packed at the start of every array, so they can be walked with a plain index and no copying.
+> Body state is copied into positions, angles and world matrices in one batched pass after each world step.
+> Owns every MclObject added to it and every generated box mesh, and recycles the objects when they are removed or the store is cleared.
+*/
+class EntityStore
+{
+public:
+	EntityStore();
+	~EntityStore();
+
+	// creation
+	MclObject* createObject(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType, Mesh* _mesh, b2World* _world);
+	Mesh* getBoxMesh(b2Vec2 _size, PrimitiveBuilder* _builder);
+	EntityHandle add(MclObject* _obj);
+	void remove(EntityHandle _handle, b2World* _world);
+
+	// updating
+	void syncFromBodies();
+	void clear();
+	void release();
+
+	// lookups
+	int size() const;
+	bool isValid(EntityHandle _handle) const;
+	int indexOf(EntityHandle _handle) const;
+	int indexOf(const b2Body* _body) const;
+	EntityHandle handleOf(int _index) const;
+	MclObject* getObject(int _index) const;
+
+	// contiguous arrays of the live entities, all indexed from 0 to size()-1
+	const b2Vec2* getPositions() const;
+	const float* getAngles() const;
+	const ObjectType* getTypes() const;
+	const Matrix44* getTransforms() const;
+
+private:
+
+	void copyFromBody(int _index);
+
+	// per entity arrays, packed so live entities are always at indices 0 to size()-1
+	vector<b2Body*> bodies;
+	vector<b2Vec2> positions;
+	vector<float> angles;
+	vector<ObjectType> types;
+	vector<Matrix44> transforms;
+	vector<MclObject*> objects;
+	vector<int> slots; // handle slot of each packed entity
+
+	// handle slots, each maps to a packed index (-1 when the slot is free)
+	vector<int> slotIndices;
+	vector<int> slotGenerations;
+	vector<int> freeSlots;
+
+	// object and mesh pools
+	vector<MclObject*> freeObjects;
+	vector<b2Vec2> boxMeshSizes;
+	vector<Mesh*> boxMeshes;
+};
@@ -32,56 +32,42 @@ void modPoints3(int _p)
 	score3 += _p;
 }
 
-/* OnCollide callback, called when two Box2D bodies collide
+/* OnCollide callback, called once when two Box2D bodies begin to touch
 
-_bodyA - One of the two bodies in collision
-_bodyB - The other body in collision
+_contact - The contact event, holding both bodies and their entity types
 */
-void onCollide3(b2Body* _bodyA, b2Body* _bodyB)
+void onCollide3(const ContactEvent& _contact)
 {
-	// get 'GameObjects' from 'Bodys'
-	GameObject* objA = (GameObject*)_bodyA->GetUserData();
-	GameObject* objB = (GameObject*)_bodyB->GetUserData();
+	// Get entity types of the colliding objects
+	ObjectType typeA = _contact.typeA;
+	ObjectType typeB = _contact.typeB;
+	b2Body* bodyB = _contact.bodyB;
 
-	if (objA != NULL && objB != NULL) // check that objects are not null
+	if (typeA != typeB) // check the two objects are not the same type of entity
 	{
-		if (objA->collideCooldown > 1 || objB->collideCooldown > 1) // check that these bodies have not recently collided
+		if (typeB == ENEMY) // check if object B is of type ENEMY
 		{
-			// Get entity types of the colliding objects
-			ObjectType typeA = objA->type_;
-			ObjectType typeB = objB->type_;
-
-			if (typeA != typeB) // check the two objects are not the same type of entity
+			if (typeA == PLAYER)
+			{
+				// if object A is type PLAYER, bounce object B and increase score by 1
+				bodyB->ApplyForce(b2Vec2(playervel3, 40.0f), bodyB->GetPosition(), true);
+				modPoints3(1);
+			}
+			else if (typeA == LEFT_WALL)
 			{
-				if (typeB == ENEMY) // check if object B is of type ENEMY
-				{
-					if (typeA == PLAYER)
-					{
-						// if object A is type PLAYER, bounce object B and increase score by 1
-						_bodyB->ApplyForce(b2Vec2(playervel3, 40.0f), _bodyB->GetPosition(), true);
-						modPoints3(1);
-					}
-					else if (typeA == LEFT_WALL)
-					{
-						// if object A is a LEFT_WALL, bounce object B right
-						_bodyB->ApplyForce(b2Vec2(10.0f, 0.0f), _bodyB->GetPosition(), true);
-					}
-					else if (typeA == RIGHT_WALL)
-					{
-						// if object A is a RIGHT_WALL, bounce object B left
-						_bodyB->ApplyForce(b2Vec2(-10.0f, 0.0f), _bodyB->GetPosition(), true);
-					}
-				}
+				// if object A is a LEFT_WALL, bounce object B right
+				bodyB->ApplyForce(b2Vec2(10.0f, 0.0f), bodyB->GetPosition(), true);
+			}
+			else if (typeA == RIGHT_WALL)
+			{
+				// if object A is a RIGHT_WALL, bounce object B left
+				bodyB->ApplyForce(b2Vec2(-10.0f, 0.0f), bodyB->GetPosition(), true);
 			}
-			
-			// play impact sound effect
-			Nexus::PLAY_AUDIO(Nexus::GET_IMPACT_SOUND());
 		}
-
-		// reset collision cooldown timers for both objects
-		objA->collideCooldown = 0;
-		objB->collideCooldown = 0;
 	}
+
+	// queue an impact sound effect, only one is played per frame however many impacts there are
+	Nexus::QUEUE_IMPACT_SOUND();
 }
 
 /* Initialize the HELP game state
@@ -126,12 +112,13 @@ void HelpState::UPDATE(Keyboard* _kb, Platform& _platform, float _frameTime)
 	Simulation::UPDATE(onCollide3);
 
 	// If a skull falls below the screen, decrease the score by 5 and reset the skull
-	vector<MclObject*> entList = Simulation::GET_ENTITIES();
-	for (int i = 0; i < entList.size(); i++)
+	const EntityStore& entities = Simulation::GET_ENTITIES();
+	const b2Vec2* positions = entities.getPositions();
+	for (int i = 0; i < entities.size(); i++)
 	{
-		MclObject* ent = entList[i];
-		if (ent->getPos().y < -1.0f)
+		if (positions[i].y < -1.0f)
 		{
+			MclObject* ent = entities.getObject(i);
 			modPoints3(-5);
 			ent->setPos(skullStart);
 			ent->setVel(b2Vec2_zero);
@@ -6,14 +6,21 @@ float timer = 0.0f;
 // The sprite for this "Splash Screen"
 Sprite splash;
 
+// The splash screen image while it is loading in the background
+AssetRequest* splashRequest = NULL;
+
+// set once the splash screen image has loaded
+bool splashLoaded = false;
+
 /* Initialize the INTRO game state
 
 _platform - Application platform
 */
 void IntroState::INIT(Platform& _platform)
 {
-	// Load the splash screen image
-	splash = Nexus::LOAD_SPRITE("wizlon_logo.png", _platform);
+	// Start loading the splash screen image, it is shown once it has loaded
+	splashRequest = Nexus::LOAD_SPRITE_ASYNC("wizlon_logo.png");
+	splashLoaded = false;
 	splash.set_position(Vector4(_platform.width()/2.0f, _platform.height()/2.0f, 0));
 }
 
@@ -25,9 +32,12 @@ _frameTime - Elapsed time on the last frame
 */
 void IntroState::UPDATE(Keyboard* _kb, Platform& _platform, float _frameTime)
 {
-	// When 1.5 seconds have elapsed, go to the MENU game state
+	// Pick up the splash screen image once it has loaded
+	if (Nexus::GET_LOADED_SPRITE(splashRequest, splash)) splashLoaded = true;
+
+	// When 1.5 seconds have elapsed and the global assets have loaded, go to the MENU game state
 	timer += _frameTime;
-	if (timer > 1.5f)
+	if (timer > 1.5f && !Nexus::LOADING())
 	{
 		Nexus::CHANGE_STATE(MENU, _platform);
 		timer = 0.0f;
@@ -41,8 +51,15 @@ void IntroState::RENDER(){}
 void IntroState::RENDER_HUD()
 {
 	// Draw the spash screen image
-	Nexus::DRAW_SPRITE(splash);
+	if (splashLoaded) Nexus::DRAW_SPRITE(splash);
 }
 
-/* Unload and clean assets for the INTRO game state (Do nothing) */
-void IntroState::CLEAN(){}
\ No newline at end of file
+/* Unload and clean assets for the INTRO game state */
+void IntroState::CLEAN()
+{
+	// cancel the splash screen image if it is still loading, otherwise delete it
+	Nexus::RELEASE_ASSET(splashRequest);
+	delete splash.texture();
+	splash.set_texture(NULL);
+	splashLoaded = false;
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include <maths/maths_kernels.h>
+#include <maths/matrix44.h>
+#include <maths/vector4.h>
+#include <maths/quaternion.h>
+#include <maths/frustum.h>
+#include <maths/aabb.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+using std::vector;
+using namespace gef;
+
+/* Microbenchmark for the gef maths kernels.
+
+Times the scalar and SIMD versions of matrix multiply, matrix inverse, point transform and batched AABB frustum culling
+on the same random data, and checks that both versions give matching results.
+Returns 1 if any results do not match.
+
+Usage: maths_bench [seed] [count] [repeats]
+*/
+
+/* Return a random float between two values
+
+_min - Lowest value
+_max - Highest value
+*/
+float randomFloat(float _min, float _max)
+{
+	return _min + (_max - _min) * ((float)rand() / (float)RAND_MAX);
+}
+
+/* Return a random rotation, scale and translation matrix like the ones built for game objects and joints */
+Matrix44 randomTransform()
+{
+	Quaternion rotation(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f));
+	rotation.Normalise();
+
+	Matrix44 scale, result;
+	scale.Scale(Vector4(randomFloat(0.5f, 2.0f), randomFloat(0.5f, 2.0f), randomFloat(0.5f, 2.0f)));
+	result.Rotation(rotation);
+	result = scale * result;
+	result.SetTranslation(Vector4(randomFloat(-100.0f, 100.0f), randomFloat(-100.0f, 100.0f), randomFloat(-100.0f, 100.0f)));
+	return result;
+}
+
+/* Return the largest difference between two arrays of floats, relative to the size of the values
+
+_a - First array
+_b - Second array
+_count - Number of floats in each array
+*/
+float maxRelativeError(const float* _a, const float* _b, int _count)
+{
+	float maxError = 0.0f;
+	for (int i = 0; i < _count; i++)
+	{
+		float error = fabsf(_a[i] - _b[i]) / fmaxf(1.0f, fabsf(_a[i]));
+		if (!(error <= maxError)) maxError = error;
+	}
+	return maxError;
+}
+
+/* Run a benchmark function a number of times and return the fastest time in milliseconds
+
+_repeats - Number of times to run the function
+_function - Function to time
+*/
+template <typename T>
+double fastestMs(int _repeats, T _function)
+{
+	double fastest = 0.0;
+	for (int i = 0; i < _repeats; i++)
+	{
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		_function();
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		if (i == 0 || ms < fastest) fastest = ms;
+	}
+	return fastest;
+}
+
+/* Print the timings and result check of one kernel, return if the results matched
+
+_name - Name of the kernel
+_scalarMs - Time taken by the scalar version
+_simdMs - Time taken by the SIMD version
+_error - Largest difference between the results
+_tolerance - Largest difference allowed
+*/
+bool report(const char* _name, double _scalarMs, double _simdMs, float _error, float _tolerance)
+{
+	bool match = _error <= _tolerance;
+	printf("%-20s scalar %9.4f ms  simd %9.4f ms  speedup %5.2fx  max error %g  %s\n",
+		_name, _scalarMs, _simdMs, _simdMs > 0.0 ? _scalarMs / _simdMs : 0.0, _error, match ? "ok" : "MISMATCH");
+	return match;
+}
+
+int main(int argc, char** argv)
+{
+	// read the benchmark settings from the command line
+	unsigned int seed = argc > 1 ? (unsigned int)atoi(argv[1]) : 1;
+	int count = argc > 2 ? atoi(argv[2]) : 100000;
+	int repeats = argc > 3 ? atoi(argv[3]) : 20;
+	srand(seed);
+
+	printf("maths_bench seed=%u count=%d repeats=%d\n", seed, count, repeats);
+
+#ifndef GEF_SIMD_SSE
+	printf("SIMD kernels are not available on this platform, nothing to compare\n");
+	return 0;
+#else
+	// random input data shared by both versions
+	vector<Matrix44> left(count), right(count);
+	vector<Vector4> points(count);
+	vector<Aabb> boxes(count);
+	for (int i = 0; i < count; i++)
+	{
+		left[i] = randomTransform();
+		right[i] = randomTransform();
+		points[i] = Vector4(randomFloat(-100.0f, 100.0f), randomFloat(-100.0f, 100.0f), randomFloat(-100.0f, 100.0f));
+
+		Vector4 centre(randomFloat(-60.0f, 60.0f), randomFloat(-60.0f, 60.0f), randomFloat(-60.0f, 60.0f));
+		Vector4 extents(randomFloat(0.1f, 5.0f), randomFloat(0.1f, 5.0f), randomFloat(0.1f, 5.0f));
+		boxes[i] = Aabb(centre - extents, centre + extents);
+	}
+
+	// a camera looking at the middle of the boxes so there is a mix of all three culling results
+	Matrix44 view, projection;
+	view.LookAt(Vector4(0.0f, 20.0f, 80.0f), Vector4(0.0f, 0.0f, 0.0f), Vector4(0.0f, 1.0f, 0.0f));
+	projection.PerspectiveFovD3D(0.8f, 16.0f / 9.0f, 1.0f, 150.0f);
+	Frustum frustum;
+	frustum.ExtractPlanesD3D(view * projection, true);
+	Plane planes[NUM_FRUSTUM_PLANES];
+	for (int p = 0; p < NUM_FRUSTUM_PLANES; p++) planes[p] = frustum.plane((FrustumPlane)p);
+
+	vector<Matrix44> scalarMatrices(count), simdMatrices(count);
+	vector<Vector4> scalarPoints(count), simdPoints(count);
+	vector<FrustumIntersect> scalarCulled(count), simdCulled(count);
+	bool allMatch = true;
+
+	// matrix multiply
+	double scalarMs = fastestMs(repeats, [&]() { for (int i = 0; i < count; i++) scalar::MatrixMultiply(scalarMatrices[i], left[i], right[i]); });
+	double simdMs = fastestMs(repeats, [&]() { for (int i = 0; i < count; i++) simd::MatrixMultiply(simdMatrices[i], left[i], right[i]); });
+	float error = maxRelativeError(scalarMatrices[0].float_ptr(), simdMatrices[0].float_ptr(), count * 16);
+	allMatch &= report("Matrix44 multiply", scalarMs, simdMs, error, 1e-5f);
+
+	// matrix inverse, the two versions use different methods so allow for rounding
+	scalarMs = fastestMs(repeats, [&]() { for (int i = 0; i < count; i++) scalar::MatrixInverse(scalarMatrices[i], left[i], NULL); });
+	simdMs = fastestMs(repeats, [&]() { for (int i = 0; i < count; i++) simd::MatrixInverse(simdMatrices[i], left[i], NULL); });
+	error = maxRelativeError(scalarMatrices[0].float_ptr(), simdMatrices[0].float_ptr(), count * 16);
+	allMatch &= report("Matrix44 inverse", scalarMs, simdMs, error, 1e-3f);
+
+	// point transform
+	scalarMs = fastestMs(repeats, [&]() { scalar::TransformPoints(left[0], &points[0], &scalarPoints[0], count); });
+	simdMs = fastestMs(repeats, [&]() { simd::TransformPoints(left[0], &points[0], &simdPoints[0], count); });
+	error = maxRelativeError(scalarPoints[0].float_ptr(), simdPoints[0].float_ptr(), count * 4);
+	allMatch &= report("TransformPoints", scalarMs, simdMs, error, 1e-5f);
+
+	// batched frustum culling, every box must get the same result
+	scalarMs = fastestMs(repeats, [&]() { scalar::FrustumIntersects(planes, &boxes[0], &scalarCulled[0], count); });
+	simdMs = fastestMs(repeats, [&]() { simd::FrustumIntersects(planes, &boxes[0], &simdCulled[0], count); });
+	int mismatches = 0;
+	int culled[3] = { 0, 0, 0 };
+	for (int i = 0; i < count; i++)
+	{
+		if (scalarCulled[i] != simdCulled[i]) mismatches++;
+		culled[simdCulled[i]]++;
+	}
+	allMatch &= report("FrustumIntersects", scalarMs, simdMs, (float)mismatches, 0.0f);
+	printf("%-20s out %d  in %d  intersects %d\n", "", culled[FI_OUT], culled[FI_IN], culled[FI_INTERSECTS]);
+
+	if (!allMatch) printf("FAILED: scalar and SIMD results do not match\n");
+	return allMatch ? 0 : 1;
+#endif
+}
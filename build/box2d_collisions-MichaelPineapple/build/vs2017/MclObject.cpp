@@ -1,5 +1,10 @@
 #include "MclObject.h"
 
+/* MclObject default constructor, 'init' must be called before the MclObject is used */
+MclObject::MclObject()
+{
+}
+
 /* MclObject constructor
 
 _position - Starting position of the new MclObject
@@ -11,6 +16,25 @@ _world - World to add this MclObject to
 */
 MclObject::MclObject(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType, Mesh* _mesh, b2World* _world)
 {
+	init(_position, _size, _dynamic, _entityType, _mesh, _world);
+}
+
+/* (Re)initialize this MclObject, used when a pooled MclObject is handed out again
+
+_position - Starting position of the MclObject
+_size - Size of the MclObject
+_dynamic - If the MclObject should be affected by physics or not
+_entityType - Type of entity this MclObject will represent
+_mesh - Mesh of the MclObject
+_world - World to add this MclObject to
+*/
+void MclObject::init(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType, Mesh* _mesh, b2World* _world)
+{
+	// reset anything left over from a previous use
+	material = Material();
+	visible = true;
+	useColour = false;
+
 	// Set the mesh
 	gameObject.set_mesh(_mesh);
 
@@ -28,12 +52,8 @@ MclObject::MclObject(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _
 	fixture_def.shape = &shape;
 	fixture_def.density = 1.0f;
 	body = _world->CreateBody(&body_def);
-	body->SetUserData(&gameObject);
 	body->CreateFixture(&fixture_def);
 
-	// prime body for physics
-	gameObject.UpdateFromSimulation(body);
-
 	// NO SLEEPING ALLOWED!
 	body->SetSleepingAllowed(false);
 }
@@ -131,22 +151,22 @@ void MclObject::clean()
 	//gameObject.mesh = NULL;
 }
 
-/* Update this MclObject within its simulation */
-void MclObject::updateFromSimulation()
+/* Forget this MclObject's Box2D body, called once the body has been destroyed */
+void MclObject::releaseBody()
 {
-	gameObject.UpdateFromSimulation(body);
+	body = NULL;
 }
 
-/* Render this MclObject
+/* Render this MclObject, the mesh is queued and drawn in a batch with others sharing its mesh and material
 
 _renderer - Object used to render 3D meshes
+_transform - World matrix of this MclObject, kept up to date by the simulation's entity store
 */
-void MclObject::render(Renderer3D* _renderer)
+void MclObject::render(Renderer3D* _renderer, const gef::Matrix44& _transform)
 {
-	if (visible)
+	if (visible && gameObject.mesh())
 	{
-		if (useColour) _renderer->set_override_material(&material);
-		else _renderer->set_override_material(NULL);
-		_renderer->DrawMesh(gameObject);
+		if (useColour) _renderer->SubmitMesh(*gameObject.mesh(), _transform, &material);
+		else _renderer->SubmitMesh(*gameObject.mesh(), _transform);
 	}
 }
\ No newline at end of file
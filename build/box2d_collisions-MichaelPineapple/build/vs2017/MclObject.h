@@ -1,7 +1,7 @@
 #pragma once
 #include <game_object.h>
 #include <primitive_builder.h>
-#include <box2d/Box2D.h>
+#include <box2d/box2d.h>
 #include <graphics/renderer_3d.h>
 #include <graphics/mesh_instance.h>
 #include <graphics/mesh.h>
@@ -18,8 +18,10 @@ class MclObject
 {
 	public:
 
-		// constructor
+		// constructors
+		MclObject();
 		MclObject(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType, Mesh* _mesh, b2World* _world);
+		void init(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType, Mesh* _mesh, b2World* _world);
 
 		// getters
 		b2Vec2 getPos();
@@ -37,16 +39,16 @@ class MclObject
 		void applyForce(b2Vec2 _force);
 
 		// other
-		void updateFromSimulation();
-		void render(Renderer3D* _renderer);
+		void render(Renderer3D* _renderer, const gef::Matrix44& _transform);
 		void clean();
+		void releaseBody();
 
 	private:
 		
 		// private member variables
 		Material material;
 		GameObject gameObject;
-		b2Body* body;
+		b2Body* body = NULL;
 		bool visible = true;
 		bool useColour = false;
 };
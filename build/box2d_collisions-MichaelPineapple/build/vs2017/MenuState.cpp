@@ -42,7 +42,7 @@ vector<MenuOption*> menuOptionsList;
 // menu options
 MenuOption* start;
 MenuOption* help;
-MenuOption* difficulty;
+MenuOption* difficultyOption;
 MenuOption* volume;
 MenuOption* quit;
 
@@ -84,7 +84,7 @@ void MenuState::INIT(Platform& _platform)
 		[](Platform& _platform) { Nexus::CHANGE_STATE(HELP, _platform); }, []() {}, []() {});
 
 	// create the 'difficulty' menu option which allows the user to change the difficulty
-	difficulty = new MenuOption("Difficulty:", middleY + 50, 
+	difficultyOption = new MenuOption("Difficulty:", middleY + 50, 
 		[](Platform& _platform) { incDiff();  }, decDiff, incDiff);
 
 	// create the 'volume' menu options which allows the user to change the audio volume
@@ -99,7 +99,7 @@ void MenuState::INIT(Platform& _platform)
 	menuOptionsList = vector<MenuOption*>();
 	menuOptionsList.push_back(start);
 	menuOptionsList.push_back(help);
-	menuOptionsList.push_back(difficulty);
+	menuOptionsList.push_back(difficultyOption);
 	menuOptionsList.push_back(volume);
 	menuOptionsList.push_back(quit);
 
@@ -157,7 +157,7 @@ void MenuState::UPDATE(Keyboard* _kb, Platform& _platform, float _frameTime)
 		case 2: diffTxt = "Difficulty: LEGEND"; break;
 		default: diffTxt = "Difficulty: NULL2"; break;
 	}
-	difficulty->text = diffTxt;
+	difficultyOption->text = diffTxt;
 	volume->text = "Volume: " + to_string(vol);
 
 	// position the 'selectionSprite' at the current menu selection
@@ -167,12 +167,13 @@ void MenuState::UPDATE(Keyboard* _kb, Platform& _platform, float _frameTime)
 	Simulation::UPDATE();
 
 	// If a skull falls below the screen, reset the skull
-	vector<MclObject*> entList = Simulation::GET_ENTITIES();
-	for (int i = 0; i < entList.size(); i++)
+	const EntityStore& entities = Simulation::GET_ENTITIES();
+	const b2Vec2* positions = entities.getPositions();
+	for (int i = 0; i < entities.size(); i++)
 	{
-		MclObject* ent = entList[i];
-		if (ent->getPos().y < -1.0f)
+		if (positions[i].y < -1.0f)
 		{
+			MclObject* ent = entities.getObject(i);
 			ent->setPos(getRndBallStart2(10.0f));
 			ent->setVel(b2Vec2_zero);
 		}
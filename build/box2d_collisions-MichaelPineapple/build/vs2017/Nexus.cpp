@@ -5,6 +5,20 @@ AudioManager* audioManager;
 SpriteRenderer* spriteRenderer;
 Renderer3D* renderer3d;
 PrimitiveBuilder* primitiveBuilder;
+gef::SceneCache* sceneCache = NULL; // owns every scene loaded by LOAD_MESH and the meshes made from them
+gef::AssetLoader* assetLoader = NULL; // loads assets in the background, see 'LOAD_SPRITE_ASYNC' and 'INITIALIZE'
+
+/* A global asset being loaded in the background by 'INITIALIZE'.
+> Only one of the destinations is set, the result is stored there once it has loaded.
+*/
+struct GlobalAsset
+{
+	AssetRequest* request;
+	Font** font;
+	Mesh** mesh;
+	int* sound;
+};
+vector<GlobalAsset> globalAssets;
 
 // variable to track the current game state
 State currentGameState = NONE;
@@ -19,6 +33,7 @@ Font* Nexus::FONT_SMALL;
 // global mesh objects
 Mesh* Nexus::MESH_PILLOW;
 Mesh* Nexus::MESH_SKULL;
+bool boxMeshesCreated = false; // set when the global meshes are boxes owned by the Nexus rather than the scene cache
 
 // global audio objects
 int Nexus::SOUND_MENU0;
@@ -28,49 +43,29 @@ int Nexus::SOUND_GOOD;
 int Nexus::SOUND_BAD;
 const int impactSoundsArraySize = 3;
 int impactSounds[3];
+bool impactSoundQueued = false; // set when an impact happened this frame
 
-/* Loads 'Scene' object from a file
+// profiler settings, see 'updateProfiler' for the keys that control them
+bool profilerHudVisible = false;
+const char* traceFilename = "profile_trace.json";
+const int traceFrames = 300; // 5 seconds at 60fps
 
-_filename - Location of the .scn file.
-_platform - Current application platform.
-*/
-Scene* loadSceneAssets(Platform& _platform, const char* _filename)
-{
-	Scene* scene = new Scene();
+// profile zone names for each gamestate, in the same order as the 'State' enum
+const char* stateUpdateZones[] = { "Nexus::NONE", "MenuState::UPDATE", "PlayState::UPDATE", "IntroState::UPDATE", "HelpState::UPDATE" };
+const char* stateRenderZones[] = { "Nexus::NONE", "MenuState::RENDER", "PlayState::RENDER", "IntroState::RENDER", "HelpState::RENDER" };
+const char* stateHudZones[] = { "Nexus::NONE", "MenuState::RENDER_HUD", "PlayState::RENDER_HUD", "IntroState::RENDER_HUD", "HelpState::RENDER_HUD" };
 
-	if (scene->ReadSceneFromFile(_platform, _filename))
-	{
-		scene->CreateMaterials(_platform);
-		scene->CreateMeshes(_platform);
-	}
-	else
-	{
-		delete scene;
-		scene = NULL;
-	}
-
-	return scene;
-}
-
-/* Loads 'Mesh' object from a 'Scene' object
-
-_scene - 'Scene' object from which to extract the mesh
-*/
-Mesh* getMeshFromSceneAssets(Scene* _scene)
-{
-	Mesh* mesh = NULL;
-	if (_scene && _scene->meshes.size() > 0) mesh = _scene->meshes.front();
-	return mesh;
-}
-
-/* Loads 'Mesh' object from a file 
+/* Loads 'Mesh' object from a file, the first mesh in the file is returned.
+Files are only read once, loading the same file again returns the same mesh.
+The mesh is owned by the scene cache and is released by 'CLEAN'.
 
 _filename - Location of the mesh .scn file.
 _platform - Current application platform.
 */
 Mesh* Nexus::LOAD_MESH(string _filename, Platform& _platform)
 {
-	return getMeshFromSceneAssets(loadSceneAssets(_platform, _filename.c_str()));
+	if (!sceneCache) sceneCache = new gef::SceneCache(_platform);
+	return sceneCache->LoadMesh(_filename.c_str());
 }
 
 /* Loads audio asset from a file, stores the audio in 'audioManager' and returns its sample ID
@@ -101,6 +96,123 @@ Sprite Nexus::LOAD_SPRITE(string _filename, Platform& _platform)
 	return $return;
 }
 
+/* Replace the global meshes with boxes of the same size as their physics bodies */
+void createBoxMeshes()
+{
+	Nexus::MESH_SKULL = primitiveBuilder->CreateBoxMesh(Vector4(0.2f, 0.25f, 0.25f));
+	Nexus::MESH_PILLOW = primitiveBuilder->CreateBoxMesh(Vector4(1.25f, 0.4f, 0.25f));
+	boxMeshesCreated = true;
+}
+
+/* Start loading a sprite image in the background, the sprite is collected with 'GET_LOADED_SPRITE'
+
+_filename - Location of the sprite image file.
+*/
+AssetRequest* Nexus::LOAD_SPRITE_ASYNC(string _filename)
+{
+	return assetLoader ? assetLoader->LoadTexture(_filename.c_str()) : NULL;
+}
+
+/* If a sprite started by 'LOAD_SPRITE_ASYNC' has finished loading, set up the sprite with it and release the request.
+Returns true if the sprite was loaded, the request is set to NULL once it has finished either way.
+The sprite's texture belongs to the caller.
+
+_request - The request returned by 'LOAD_SPRITE_ASYNC'
+_sprite - Sprite to give the texture to
+*/
+bool Nexus::GET_LOADED_SPRITE(AssetRequest*& _request, Sprite& _sprite)
+{
+	if (!_request || !_request->finished()) return false;
+
+	bool loaded = _request->status() == gef::ASSET_READY;
+	if (loaded)
+	{
+		_sprite.set_texture(_request->texture());
+		_sprite.set_width((float)_request->width());
+		_sprite.set_height((float)_request->height());
+	}
+
+	RELEASE_ASSET(_request);
+	return loaded;
+}
+
+/* Release a request made to the asset loader, if it is still loading it is cancelled
+
+_request - The request to release, set to NULL
+*/
+void Nexus::RELEASE_ASSET(AssetRequest*& _request)
+{
+	if (assetLoader) assetLoader->Release(_request);
+	_request = NULL;
+}
+
+/* Returns true while the global fonts, meshes and sounds started by 'INITIALIZE' are still loading */
+bool Nexus::LOADING()
+{
+	return !globalAssets.empty();
+}
+
+/* Store any global assets that have finished loading in the Nexus.
+Once they have all finished, fall back to box meshes if the meshes failed and report how long everything took.
+*/
+void collectGlobalAssets()
+{
+	if (globalAssets.empty()) return;
+
+	for (int i = 0; i < (int)globalAssets.size(); i++)
+	{
+		GlobalAsset& asset = globalAssets[i];
+		if (!asset.request->finished()) continue;
+
+		if (asset.font) *asset.font = asset.request->font();
+		if (asset.mesh) *asset.mesh = asset.request->mesh();
+		if (asset.sound) *asset.sound = asset.request->sample_index();
+		if (asset.request->status() == gef::ASSET_FAILED) DebugOut("Failed to load %s\n", asset.request->filename().c_str());
+
+		assetLoader->Release(asset.request);
+		globalAssets.erase(globalAssets.begin() + i);
+		i--;
+	}
+
+	if (globalAssets.empty())
+	{
+		// check meshes have loaded properly
+		if (!Nexus::MESH_SKULL || !Nexus::MESH_PILLOW)
+		{
+			DebugOut("Mesh file failed to load!");
+			createBoxMeshes();
+		}
+
+		// report how long each asset took
+		const vector<gef::AssetTiming>& timings = assetLoader->timings();
+		for (int i = 0; i < (int)timings.size(); i++)
+		{
+			const gef::AssetTiming& timing = timings[i];
+			DebugOut("%-8s %-24s %s  wait %7.2f ms  decode %7.2f ms  finish %7.2f ms  total %7.2f ms\n",
+				gef::AssetLoader::AssetTypeName(timing.type), timing.filename.c_str(), timing.success ? "ok    " : "FAILED",
+				timing.wait_ms, timing.decode_ms, timing.finish_ms, timing.total_ms);
+		}
+		assetLoader->ClearTimings();
+	}
+}
+
+/* Wait for the global assets started by 'INITIALIZE' to finish loading */
+void Nexus::FINISH_LOADING()
+{
+	if (!assetLoader) return;
+
+	assetLoader->FinishAll();
+	collectGlobalAssets();
+}
+
+/* Pass the zones Box2D marks while stepping a world on to the gef profiler */
+void connectProfiler()
+{
+#ifdef GEF_PROFILER
+	b2SetProfileZoneCallbacks(Profiler::BeginZone, Profiler::EndZone);
+#endif
+}
+
 /* Initialize the 'Nexus' class
 
 _startState - State to start the game in, should be 'INTRO' usually
@@ -110,6 +222,7 @@ _renderer3d - Object used to render 3d meshes
 void Nexus::INITIALIZE(State _startState, Platform& _platform, Renderer3D* _renderer3d)
 {
 	srand(time(NULL));
+	connectProfiler();
 
 	// initialze the manager objects which interface with the GEF framework
 	audioManager = AudioManager::Create();
@@ -118,37 +231,65 @@ void Nexus::INITIALIZE(State _startState, Platform& _platform, Renderer3D* _rend
 	renderer3d = _renderer3d;
 	primitiveBuilder = new PrimitiveBuilder(_platform);
 
-	// loads global fonts
-	FONT_LARGE = new Font(_platform);
-	FONT_SMALL = new Font(_platform);
-	FONT_LARGE->Load("fonts/font");
-	FONT_SMALL->Load("fonts/font_small");
+	// start loading the global fonts, meshes and sounds in the background, they are stored in the Nexus as they finish
+	// and the intro is shown in the meantime. Until then the fonts are NULL and the sounds -1.
+	assetLoader = new gef::AssetLoader(_platform);
+	sceneCache = new gef::SceneCache(_platform);
+	FONT_LARGE = NULL;
+	FONT_SMALL = NULL;
+	MESH_SKULL = NULL;
+	MESH_PILLOW = NULL;
+	SOUND_MENU0 = SOUND_MENU1 = SOUND_MENU2 = SOUND_GOOD = SOUND_BAD = -1;
+	for (int i = 0; i < impactSoundsArraySize; i++) impactSounds[i] = -1;
+
+	GlobalAsset fonts[] = {
+		{ assetLoader->LoadFont("fonts/font"), &FONT_LARGE, NULL, NULL },
+		{ assetLoader->LoadFont("fonts/font_small"), &FONT_SMALL, NULL, NULL } };
+	GlobalAsset meshes[] = {
+		{ assetLoader->LoadScene(sceneCache, "skull.scn"), NULL, &MESH_SKULL, NULL },
+		{ assetLoader->LoadScene(sceneCache, "pillow.scn"), NULL, &MESH_PILLOW, NULL } };
+	GlobalAsset sounds[] = {
+		{ assetLoader->LoadSample(audioManager, "audio/select_008.ogg"), NULL, NULL, &SOUND_MENU0 },
+		{ assetLoader->LoadSample(audioManager, "audio/switch_007.ogg"), NULL, NULL, &SOUND_MENU1 },
+		{ assetLoader->LoadSample(audioManager, "audio/select_006.ogg"), NULL, NULL, &SOUND_MENU2 },
+		{ assetLoader->LoadSample(audioManager, "audio/point.ogg"), NULL, NULL, &SOUND_GOOD },
+		{ assetLoader->LoadSample(audioManager, "audio/fail.ogg"), NULL, NULL, &SOUND_BAD },
+		{ assetLoader->LoadSample(audioManager, "audio/impact07.ogg"), NULL, NULL, &impactSounds[0] },
+		{ assetLoader->LoadSample(audioManager, "audio/impact08.ogg"), NULL, NULL, &impactSounds[1] },
+		{ assetLoader->LoadSample(audioManager, "audio/impact09.ogg"), NULL, NULL, &impactSounds[2] } };
+	globalAssets.insert(globalAssets.end(), fonts, fonts + 2);
+	globalAssets.insert(globalAssets.end(), meshes, meshes + 2);
+	globalAssets.insert(globalAssets.end(), sounds, sounds + 8);
+
+	// set the current state to the provided startstate
+	CHANGE_STATE(_startState, _platform);
+}
+
+/* Initialize the 'Nexus' class without audio, fonts, 2D rendering, mesh files or a starting state.
+Used to drive the simulation from headless tools such as the stress benchmark.
 
-	// load global meshes
-	MESH_SKULL = LOAD_MESH("skull.scn", _platform);
-	MESH_PILLOW = LOAD_MESH("pillow.scn", _platform);
+_platform - The current application platform
+_renderer3d - Object used to render 3d meshes, may be NULL or a counting null renderer
+*/
+void Nexus::INITIALIZE_HEADLESS(Platform& _platform, Renderer3D* _renderer3d)
+{
+	connectProfiler();
 
-	// check meshes have loaded properly
-	if (!MESH_SKULL || !MESH_PILLOW)
-	{
-		DebugOut("Mesh file failed to load!");
+	audioManager = NULL;
+	spriteRenderer = NULL;
+	renderer3d = _renderer3d;
+	primitiveBuilder = new PrimitiveBuilder(_platform);
 
-		MESH_SKULL = primitiveBuilder->CreateBoxMesh(Vector4(0.2f, 0.25f, 0.25f));
-		MESH_PILLOW = primitiveBuilder->CreateBoxMesh(Vector4(1.25f, 0.4f, 0.25f));
-	}
+	FONT_LARGE = NULL;
+	FONT_SMALL = NULL;
 
-	// load audio
-	SOUND_MENU0 = LOAD_AUDIO("select_008.ogg", _platform);
-	SOUND_MENU1 = LOAD_AUDIO("switch_007.ogg", _platform);
-	SOUND_MENU2 = LOAD_AUDIO("select_006.ogg", _platform);
-	SOUND_GOOD = LOAD_AUDIO("point.ogg", _platform);
-	SOUND_BAD = LOAD_AUDIO("fail.ogg", _platform);
-	impactSounds[0] = LOAD_AUDIO("impact07.ogg", _platform);
-	impactSounds[1] = LOAD_AUDIO("impact08.ogg", _platform);
-	impactSounds[2] = LOAD_AUDIO("impact09.ogg", _platform);
+	// physics does not depend on the meshes, so skip loading them from disk
+	createBoxMeshes();
 
-	// set the current state to the provided startstate
-	CHANGE_STATE(_startState, _platform);
+	SOUND_MENU0 = SOUND_MENU1 = SOUND_MENU2 = SOUND_GOOD = SOUND_BAD = -1;
+	for (int i = 0; i < impactSoundsArraySize; i++) impactSounds[i] = -1;
+
+	currentGameState = NONE;
 }
 
 /* Returns a random pre-loaded impact sound */
@@ -157,19 +298,27 @@ int Nexus::GET_IMPACT_SOUND()
 	return impactSounds[Nexus::RND(0, impactSoundsArraySize - 1)];
 }
 
+/* Queue an impact sound to be played at the end of the frame.
+Any number of impacts in one frame only plays a single sound.
+*/
+void Nexus::QUEUE_IMPACT_SOUND()
+{
+	impactSoundQueued = true;
+}
+
 /* Plays the provided audio
 
 _audioID - ID of the sample to play
 */
 void Nexus::PLAY_AUDIO(int _audioID)
 {
-	audioManager->PlaySample(_audioID, false);
+	if (audioManager && _audioID >= 0) audioManager->PlaySample(_audioID, false);
 }
 
 /* Play the pre-loaded music */
 void Nexus::PLAY_MUSIC()
 {
-	if (!musicPlaying)
+	if (!musicPlaying && audioManager)
 	{
 		audioManager->PlayMusic();
 		musicPlaying = true;
@@ -179,7 +328,7 @@ void Nexus::PLAY_MUSIC()
 /* Stop the music if it is currently playing */
 void Nexus::STOP_MUSIC()
 {
-	if (musicPlaying)
+	if (musicPlaying && audioManager)
 	{
 		audioManager->StopMusic();
 		musicPlaying = false;
@@ -194,7 +343,7 @@ void Nexus::SET_VOLUME(int _vol)
 {
 	if (_vol > 100) _vol = 100;
 	else if (_vol < 0) _vol = 0;
-	audioManager->SetMasterVolume(_vol);
+	if (audioManager) audioManager->SetMasterVolume(_vol);
 }
 
 /* Draw text to the screen 
@@ -223,10 +372,11 @@ void Nexus::DRAW_SPRITE(Sprite _sprite)
 /* Draw the 3d mesh stored within a MclObject 
 
 _mcl - 'MclObject' to draw.
+_transform - World matrix to draw the 'MclObject' with.
 */
-void Nexus::DRAW_MCLOBJ(MclObject* _mcl)
+void Nexus::DRAW_MCLOBJ(MclObject* _mcl, const gef::Matrix44& _transform)
 {
-	_mcl->render(renderer3d);
+	if (renderer3d) _mcl->render(renderer3d, _transform);
 }
 
 /* Returns the global primative builder */
@@ -245,6 +395,63 @@ int Nexus::RND(int _min, int _max)
 	return _min + (rand() % static_cast<int>(_max - _min + 1));
 }
 
+/* Handle the profiler keys. F1 shows or hides the profiler summary, F2 writes the next few seconds to a Chrome trace file.
+
+_kb - Keyboard input data
+*/
+void updateProfiler(Keyboard* _kb)
+{
+	if (!_kb) return;
+
+	if (_kb->IsKeyPressed(Keyboard::KC_F1))
+	{
+		profilerHudVisible = !profilerHudVisible;
+		Profiler::SetEnabled(profilerHudVisible);
+	}
+
+	if (_kb->IsKeyPressed(Keyboard::KC_F2) && Profiler::CaptureTrace(traceFilename, traceFrames))
+		DebugOut("Capturing %d frames to %s\n", traceFrames, traceFilename);
+}
+
+/* Draw the profiler summary over the HUD of the current gamestate, if it is visible */
+void drawProfilerHud()
+{
+	if (!profilerHudVisible || !Nexus::FONT_SMALL) return;
+
+	const gef::ProfileSummary& summary = Profiler::summary();
+	float x = 10.0f;
+	float y = 40.0f;
+	float lineHeight = 25.0f;
+	char line[128];
+
+	if (summary.num_frames == 0)
+	{
+		Nexus::DRAW_TXT("profiling...", x, y, TJ_LEFT, Nexus::FONT_SMALL);
+		return;
+	}
+
+	snprintf(line, sizeof(line), "frame %.2f ms  allocs %.0f (%.1f KB)  frees %.0f", summary.frame_ms, summary.allocations, summary.allocated_kb, summary.frees);
+	Nexus::DRAW_TXT(line, x, y, TJ_LEFT, Nexus::FONT_SMALL);
+	y += lineHeight;
+
+	if (Profiler::capturing())
+	{
+		Nexus::DRAW_TXT(string("capturing ") + traceFilename, x, y, TJ_LEFT, Nexus::FONT_SMALL);
+		y += lineHeight;
+	}
+
+	// the slowest zones, with the time per frame lined up on the right
+	const int maxZones = 10;
+	for (int i = 0; i < (int)summary.zones.size() && i < maxZones; i++)
+	{
+		const gef::ProfileZoneStats& zone = summary.zones[i];
+		Nexus::DRAW_TXT(zone.name, x, y, TJ_LEFT, Nexus::FONT_SMALL);
+		snprintf(line, sizeof(line), "%.2f ms x%.0f", zone.ms, zone.calls);
+		Nexus::DRAW_TXT(line, x + 520.0f, y, TJ_RIGHT, Nexus::FONT_SMALL);
+		y += lineHeight;
+	}
+}
+
 /* Update the current gamestate
 
 _kb - Keyboard input data
@@ -253,28 +460,53 @@ _frameTime - How many seconds the last frame took to calculate
 */
 void Nexus::UPDATE(Keyboard* _kb, Platform& _platform, float _frameTime)
 {
-	switch (currentGameState)
+	GEF_PROFILE_ZONE("Nexus::UPDATE");
+	updateProfiler(_kb);
+
+	// finish anything loaded in the background since the last frame
+	if (assetLoader)
 	{
-		case MENU:MenuState::UPDATE(_kb, _platform, _frameTime);break;
-		case PLAY:PlayState::UPDATE(_kb, _platform, _frameTime);break;
-		case INTRO:IntroState::UPDATE(_kb, _platform, _frameTime);break;
-		case HELP:HelpState::UPDATE(_kb, _platform, _frameTime);break;
-		default:break;
+		assetLoader->Update();
+		collectGlobalAssets();
+	}
+
+	{
+		GEF_PROFILE_ZONE(stateUpdateZones[currentGameState]);
+		switch (currentGameState)
+		{
+			case MENU:MenuState::UPDATE(_kb, _platform, _frameTime);break;
+			case PLAY:PlayState::UPDATE(_kb, _platform, _frameTime);break;
+			case INTRO:IntroState::UPDATE(_kb, _platform, _frameTime);break;
+			case HELP:HelpState::UPDATE(_kb, _platform, _frameTime);break;
+			default:break;
+		}
+	}
+
+	// play the impact sound queued by this frame's collisions
+	if (impactSoundQueued)
+	{
+		PLAY_AUDIO(GET_IMPACT_SOUND());
+		impactSoundQueued = false;
 	}
 }
 
 /* Render the current gamestate */
 void Nexus::RENDER()
 {
+	GEF_PROFILE_ZONE("Nexus::RENDER");
+
 	// Render 3D meshes
 	renderer3d->Begin();
-	switch (currentGameState)
 	{
-		case MENU:MenuState::RENDER();break;
-		case PLAY:PlayState::RENDER();break;
-		case INTRO:IntroState::RENDER();break;
-		case HELP:HelpState::RENDER();break;
-		default:break;
+		GEF_PROFILE_ZONE(stateRenderZones[currentGameState]);
+		switch (currentGameState)
+		{
+			case MENU:MenuState::RENDER();break;
+			case PLAY:PlayState::RENDER();break;
+			case INTRO:IntroState::RENDER();break;
+			case HELP:HelpState::RENDER();break;
+			default:break;
+		}
 	}
 	renderer3d->End();
 
@@ -282,6 +514,7 @@ void Nexus::RENDER()
 	spriteRenderer->Begin(false);
 	if (FONT_LARGE && FONT_SMALL) // make sure all fonts are loaded properly
 	{
+		GEF_PROFILE_ZONE(stateHudZones[currentGameState]);
 		switch (currentGameState)
 		{
 			case MENU:MenuState::RENDER_HUD();break;
@@ -291,6 +524,7 @@ void Nexus::RENDER()
 			default:break;
 		}
 	}
+	drawProfilerHud();
 	spriteRenderer->End();
 }
 
@@ -311,11 +545,21 @@ void cleanStates()
 void Nexus::CLEAN()
 {
 	cleanStates();
+	Simulation::RELEASE();
+
+	// anything still loading is thrown away with the loader
+	for (int i = 0; i < (int)globalAssets.size(); i++) assetLoader->Release(globalAssets[i].request);
+	globalAssets.clear();
+	delete assetLoader;
+	assetLoader = NULL;
 
 	STOP_MUSIC();
-	audioManager->UnloadMusic();
-	audioManager->UnloadAllSamples();
-	audioManager = NULL;
+	if (audioManager)
+	{
+		audioManager->UnloadMusic();
+		audioManager->UnloadAllSamples();
+		audioManager = NULL;
+	}
 
 	delete spriteRenderer;
 	spriteRenderer = NULL;
@@ -328,6 +572,19 @@ void Nexus::CLEAN()
 
 	delete FONT_SMALL;
 	FONT_SMALL = NULL;
+
+	// the box meshes belong to the Nexus, loaded meshes belong to the scene cache
+	if (boxMeshesCreated)
+	{
+		delete MESH_SKULL;
+		delete MESH_PILLOW;
+		boxMeshesCreated = false;
+	}
+	MESH_SKULL = NULL;
+	MESH_PILLOW = NULL;
+
+	delete sceneCache;
+	sceneCache = NULL;
 }
 
 /* Change the current gamestate 
@@ -340,6 +597,9 @@ void Nexus::CHANGE_STATE(State _newState, Platform& _platform)
 	// Clean the old gamestate
 	cleanStates();
 
+	// every state apart from the intro needs the global meshes and sounds, so make sure they have loaded
+	if (_newState != INTRO) FINISH_LOADING();
+
 	// store the new gamestate
 	currentGameState = _newState;
 
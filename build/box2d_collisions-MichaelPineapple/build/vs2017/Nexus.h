@@ -4,15 +4,19 @@
 #include <time.h>
 #include <vector>
 #include <string>
-#include <box2d/Box2D.h>
+#include <cstdio>
+#include <box2d/box2d.h>
 #include <system/platform.h>
 #include <system/debug_log.h>
+#include <system/profiler.h>
 #include <audio/audio_manager.h>
 #include <graphics/sprite_renderer.h>
 #include <graphics/renderer_3d.h>
 #include <graphics/font.h>
 #include <graphics/sprite.h>
 #include <graphics/scene.h>
+#include <graphics/scene_cache.h>
+#include <assets/asset_loader.h>
 #include <graphics/texture.h>
 #include <graphics/image_data.h>
 #include <assets/png_loader.h>
@@ -21,7 +25,7 @@
 #include <game_object.h>
 #include <primitive_builder.h>
 #include <MclObject.h>
-#include <platform/d3d11/system/platform_d3d11.h>
+#include <EntityStore.h>
 using std::vector;
 using std::string;
 using std::to_string;
@@ -38,10 +42,12 @@ using gef::MeshInstance;
 using gef::Platform;
 using gef::Keyboard;
 using gef::SpriteRenderer;
+using gef::AssetRequest;
 using gef::Font;
 using gef::Renderer3D;
 using gef::TextJustification;
 using gef::DebugOut;
+using gef::Profiler;
 using gef::TJ_CENTRE;
 using gef::TJ_RIGHT;
 using gef::TJ_LEFT;
@@ -56,6 +62,26 @@ enum State
 	HELP,
 };
 
+// Enum to denote the kind of contact event recorded during a simulation step.
+enum ContactEventType
+{
+	CONTACT_BEGIN,
+	CONTACT_END,
+};
+
+/* ContactEvent struct, a single contact beginning or ending during a simulation step.
+> Recorded by the simulation's contact listener while the Box2D world steps.
+*/
+struct ContactEvent
+{
+	ContactEventType eventType;
+	b2Body* bodyA;
+	b2Body* bodyB;
+	ObjectType typeA;
+	ObjectType typeB;
+	float approachSpeed; // speed of A towards B along the contact normal (begin events only)
+};
+
 /* Nexus class, central hub of the application. 
 > Provides static global functions for loading & rendering assets.
 > Stores some global pre-loaded assets for use throughout the game.
@@ -65,6 +91,7 @@ class Nexus
 {
 public:
 	static void INITIALIZE(State _startState, Platform& _platform, Renderer3D* _renderer3d);
+	static void INITIALIZE_HEADLESS(Platform& _platform, Renderer3D* _renderer3d);
 	static void UPDATE(Keyboard* _kb, Platform& _platform, float _frameTime);
 	static void RENDER();
 	static void CLEAN();
@@ -76,13 +103,19 @@ public:
 	static void STOP_MUSIC();
 	static void SET_VOLUME(int _vol);
 	static int GET_IMPACT_SOUND();
+	static void QUEUE_IMPACT_SOUND();
 
 	static Sprite LOAD_SPRITE(string _filename, Platform& _platform);
 	static Mesh* LOAD_MESH(string _filename, Platform& _platform);
+	static AssetRequest* LOAD_SPRITE_ASYNC(string _filename);
+	static bool GET_LOADED_SPRITE(AssetRequest*& _request, Sprite& _sprite);
+	static void RELEASE_ASSET(AssetRequest*& _request);
+	static bool LOADING();
+	static void FINISH_LOADING();
 
 	static void DRAW_TXT(string _txt, float _x, float _y, TextJustification _tj, Font* _font);
 	static void DRAW_SPRITE(Sprite _sprite);
-	static void DRAW_MCLOBJ(MclObject* _mcl);
+	static void DRAW_MCLOBJ(MclObject* _mcl, const gef::Matrix44& _transform);
 
 	static PrimitiveBuilder* GET_PRIMITIVE_BUILDER();
 
@@ -105,14 +138,18 @@ public:
 	static void INITIALIZE(Platform& _platform, float _gravity);
 	static MclObject* CREATE_ENTITY(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType);
 	static MclObject* CREATE_ENTITY(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType, Mesh* _mesh);
-	static void ADD_ENTITY(MclObject* _obj);
-	static void ADD_ENTITY(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType);
-	static void ADD_ENTITY(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType, Mesh* _mesh);
-	static void UPDATE(void (*_onCollide)(b2Body*, b2Body*));
+	static EntityHandle ADD_ENTITY(MclObject* _obj);
+	static EntityHandle ADD_ENTITY(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType);
+	static EntityHandle ADD_ENTITY(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType, Mesh* _mesh);
+	static void REMOVE_ENTITY(EntityHandle _handle);
+	static void UPDATE(void (*_onCollide)(const ContactEvent&));
 	static void UPDATE();
 	static void RENDER();
 	static void CLEAN();
-	static vector<MclObject*> GET_ENTITIES();
+	static void RELEASE();
+	static const EntityStore& GET_ENTITIES();
+	static const vector<ContactEvent>& GET_CONTACT_EVENTS();
+	static b2World* GET_WORLD();
 };
 
 /* MenuState class, contains all functions related to the MENU gamestate */
@@ -147,6 +184,10 @@ public:
 	static void RENDER_HUD();
 	static void CLEAN();
 	static void SET_DIFFICULTY(int _difficulty);
+	static void CREATE_ARENA(int _skullCount);
+	static EntityHandle SPAWN_SKULL();
+	static void RESET_FALLEN_SKULLS();
+	static void ON_COLLIDE(const ContactEvent& _contact);
 };
 
 /* HelpState class, contains all functions related to the HELP gamestate */
@@ -50,56 +50,42 @@ b2Vec2 getRndBallStart()
 	return b2Vec2(Nexus::RND(-3, 3), Nexus::RND(10, 20));
 }
 
-/* OnCollide callback, called when two Box2D bodies collide
+/* OnCollide callback, called once when two Box2D bodies begin to touch
 
-_bodyA - One of the two bodies in collision
-_bodyB - The other body in collision
+_contact - The contact event, holding both bodies and their entity types
 */
-void onCollide(b2Body* _bodyA, b2Body* _bodyB)
+void PlayState::ON_COLLIDE(const ContactEvent& _contact)
 {
-	// get 'GameObjects' from 'Bodys'
-	GameObject* objA = (GameObject*)_bodyA->GetUserData();
-	GameObject* objB = (GameObject*)_bodyB->GetUserData();
+	// Get entity types of the colliding objects
+	ObjectType typeA = _contact.typeA;
+	ObjectType typeB = _contact.typeB;
+	b2Body* bodyB = _contact.bodyB;
 
-	if (objA != NULL && objB != NULL) // check that objects are not null
+	if (typeA != typeB) // check the two objects are not the same type of entity
 	{
-		if (objA->collideCooldown > 1 || objB->collideCooldown > 1) // check that these bodies have not recently collided
+		if (typeB == ENEMY) // check if object B is of type ENEMY
 		{
-			// Get entity types of the colliding objects
-			ObjectType typeA = objA->type_;
-			ObjectType typeB = objB->type_;
-
-			if (typeA != typeB)  // check the two objects are not the same type of entity
+			if (typeA == PLAYER)
 			{
-				if (typeB == ENEMY) // check if object B is of type ENEMY
-				{
-					if (typeA == PLAYER)
-					{
-						// if object A is type PLAYER, bounce object B and increase score by 1
-						_bodyB->ApplyForce(b2Vec2(playervel, 70.0f), _bodyB->GetPosition(), true);
-						modPoints(1);
-					}
-					else if (typeA == LEFT_WALL)
-					{
-						// if object A is a LEFT_WALL, bounce object B right
-						_bodyB->ApplyForce(b2Vec2(10.0f, 0.0f), _bodyB->GetPosition(), true);
-					}
-					else if (typeA == RIGHT_WALL)
-					{
-						// if object A is a RIGHT_WALL, bounce object B left
-						_bodyB->ApplyForce(b2Vec2(-10.0f, 0.0f), _bodyB->GetPosition(), true);
-					}
-				}
+				// if object A is type PLAYER, bounce object B and increase score by 1
+				bodyB->ApplyForce(b2Vec2(playervel, 70.0f), bodyB->GetPosition(), true);
+				modPoints(1);
+			}
+			else if (typeA == LEFT_WALL)
+			{
+				// if object A is a LEFT_WALL, bounce object B right
+				bodyB->ApplyForce(b2Vec2(10.0f, 0.0f), bodyB->GetPosition(), true);
+			}
+			else if (typeA == RIGHT_WALL)
+			{
+				// if object A is a RIGHT_WALL, bounce object B left
+				bodyB->ApplyForce(b2Vec2(-10.0f, 0.0f), bodyB->GetPosition(), true);
 			}
-
-			// play impact sound effect
-			Nexus::PLAY_AUDIO(Nexus::GET_IMPACT_SOUND());
 		}
-
-		// reset collision cooldown timers for both objects
-		objA->collideCooldown = 0;
-		objB->collideCooldown = 0;
 	}
+
+	// queue an impact sound effect, only one is played per frame however many impacts there are
+	Nexus::QUEUE_IMPACT_SOUND();
 }
 
 
@@ -134,6 +120,17 @@ void PlayState::INIT(Platform& _platform)
 		default: ballsnum = 0; break;
 	}
 
+	// create the walls, player and skulls
+	CREATE_ARENA(ballsnum);
+}
+
+/* Create the walls, the player and the skulls in the current simulation.
+Also used by the headless stress benchmark.
+
+_skullCount - Number of skulls to spawn above the screen
+*/
+void PlayState::CREATE_ARENA(int _skullCount)
+{
 	// Create left and right walls to keep skulls from moving off the screen
 	MclObject* leftWall = Simulation::CREATE_ENTITY(b2Vec2(-7.6f, 0.0f), b2Vec2(1.0f, 200.0f), false, LEFT_WALL);
 	MclObject* rightWall = Simulation::CREATE_ENTITY(b2Vec2(7.6f, 0.0f), b2Vec2(1.0f, 200.0f), false, RIGHT_WALL);
@@ -147,12 +144,17 @@ void PlayState::INIT(Platform& _platform)
 	Simulation::ADD_ENTITY(player);
 
 	// create skulls above the screen at random positions and rotations
-	for (int i = 0; i < ballsnum; i++)
-	{
-		MclObject* skulltmp = Simulation::CREATE_ENTITY(getRndBallStart(), b2Vec2(0.4f, 0.5f), true, ENEMY, Nexus::MESH_SKULL);
-		skulltmp->getBody()->SetAngularVelocity(Nexus::RND(-1000, 1000)/100.0f);
-		Simulation::ADD_ENTITY(skulltmp);
-	}
+	for (int i = 0; i < _skullCount; i++) SPAWN_SKULL();
+}
+
+/* Add a skull to the current simulation above the screen at a random position and rotation, return its handle.
+Also used by the headless stress benchmark.
+*/
+EntityHandle PlayState::SPAWN_SKULL()
+{
+	MclObject* skulltmp = Simulation::CREATE_ENTITY(getRndBallStart(), b2Vec2(0.4f, 0.5f), true, ENEMY, Nexus::MESH_SKULL);
+	skulltmp->getBody()->SetAngularVelocity(Nexus::RND(-1000, 1000)/100.0f);
+	return Simulation::ADD_ENTITY(skulltmp);
 }
 
 /* Update the PLAY game state
@@ -175,20 +177,10 @@ void PlayState::UPDATE(Keyboard* _kb, Platform& _platform, float _frameTime)
 	}
 
 	// Update the phyics simulation, pass it the onCollide callback
-	Simulation::UPDATE(onCollide);
+	Simulation::UPDATE(ON_COLLIDE);
 
-	// If a skull falls below the screen, decrease the score by 5 and reset the skull
-	vector<MclObject*> entList = Simulation::GET_ENTITIES();
-	for (int i = 0; i < entList.size(); i++)
-	{
-		MclObject* ent = entList[i];
-		if (ent->getPos().y < -1.0f)
-		{
-			modPoints(-5);
-			ent->setPos(getRndBallStart());
-			ent->setVel(b2Vec2_zero);
-		}
-	}
+	// reset any skulls that fell off the screen
+	RESET_FALLEN_SKULLS();
 
 	// Control the player. LEFT key moves the pillow left and RIGHT key moves it right. keep track of the player's horizontal velocity
 	playervel = 0.0f;
@@ -211,6 +203,23 @@ void PlayState::UPDATE(Keyboard* _kb, Platform& _platform, float _frameTime)
 	}
 }
 
+/* If a skull falls below the screen, decrease the score by 5 and reset the skull */
+void PlayState::RESET_FALLEN_SKULLS()
+{
+	const EntityStore& entities = Simulation::GET_ENTITIES();
+	const b2Vec2* positions = entities.getPositions();
+	for (int i = 0; i < entities.size(); i++)
+	{
+		if (positions[i].y < -1.0f)
+		{
+			MclObject* ent = entities.getObject(i);
+			modPoints(-5);
+			ent->setPos(getRndBallStart());
+			ent->setVel(b2Vec2_zero);
+		}
+	}
+}
+
 /* Render 3D meshes for the PLAY game state */
 void PlayState::RENDER()
 {
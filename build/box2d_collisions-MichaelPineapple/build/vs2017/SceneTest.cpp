@@ -0,0 +1,334 @@
+#include <graphics/scene.h>
+#include <graphics/scene_cache.h>
+#include <graphics/mesh_data.h>
+#include <graphics/mesh.h>
+#include <animation/skeleton.h>
+#include <system/string_id.h>
+#include <platform/null/system/platform_null.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+using std::vector;
+using namespace gef;
+
+/* Test for the mapped scene file format and the scene cache.
+
+Builds a small scene in code, writes it with WriteMappedScene and checks that reading it back gives the same vertex,
+index, material and string data. Then checks that truncated and corrupt copies of the file fail to read without adding
+anything to the scene, that writing to a mapped scene's vertices doesn't change the file, and that loading the same
+file from a SceneCache twice returns the same scene and mesh.
+Returns 1 if any check fails.
+
+Usage: scene_test [directory]
+The test files are written to the directory, which defaults to the current one.
+*/
+
+// Layout of the mapped scene file, as written by gef. Only the fields the corruptions change are needed.
+static const size_t HEADER_SIZE = 52;
+static const size_t HEADER_STRINGS_OFFSET = 16;
+static const size_t HEADER_MESHES_OFFSET = 32;
+static const size_t HEADER_SKELETON_COUNT = 36;
+static const size_t MESH_RECORD_SIZE = 48;
+static const size_t MESH_RECORD_PRIMITIVES_OFFSET = 44;
+
+static const int MESH_COUNT = 3;
+static const int VERTEX_COUNT = 64;
+static const int PRIMITIVE_COUNT = 2;
+static const int INDEX_COUNT = 30;
+
+// Number of checks which have failed
+static int failures = 0;
+
+/* Print a check's result and count it if it failed
+
+_passed - If the check passed
+_description - What was checked
+*/
+void check(bool _passed, const char* _description)
+{
+	printf("%-64s %s\n", _description, _passed ? "ok" : "FAILED");
+	if (!_passed) failures++;
+}
+
+/* Build a scene with a few meshes, materials and a skeleton, filled with known data
+
+_scene - Scene to fill in
+*/
+void buildScene(Scene& _scene)
+{
+	// the material and mesh names go in the string table
+	_scene.string_id_table.Add("skull_material");
+	_scene.string_id_table.Add("bone_material");
+	_scene.string_id_table.Add("skull.png");
+
+	_scene.material_data.push_back(MaterialData());
+	_scene.material_data.back().name_id = GetStringId("skull_material");
+	_scene.material_data.back().colour = 0xff8040c0;
+	_scene.material_data.back().diffuse_texture = "skull.png";
+
+	_scene.material_data.push_back(MaterialData());
+	_scene.material_data.back().name_id = GetStringId("bone_material");
+	_scene.material_data.back().colour = 0xffffffff;
+
+	for (int meshNum = 0; meshNum < MESH_COUNT; meshNum++)
+	{
+		char name[32];
+		sprintf(name, "mesh_%d", meshNum);
+		_scene.string_id_table.Add(name);
+
+		_scene.mesh_data.push_back(MeshData());
+		MeshData& mesh = _scene.mesh_data.back();
+		mesh.name_id = GetStringId(name);
+		mesh.aabb.Update(Vector4(-1.0f - meshNum, -2.0f, -3.0f));
+		mesh.aabb.Update(Vector4(1.0f + meshNum, 2.0f, 3.0f));
+
+		mesh.vertex_data.num_vertices = VERTEX_COUNT;
+		mesh.vertex_data.vertex_byte_size = sizeof(Mesh::Vertex);
+		mesh.vertex_data.vertices = malloc(VERTEX_COUNT * sizeof(Mesh::Vertex));
+		unsigned char* vertexBytes = (unsigned char*)mesh.vertex_data.vertices;
+		for (int i = 0; i < VERTEX_COUNT * (int)sizeof(Mesh::Vertex); i++) vertexBytes[i] = (unsigned char)(i * 7 + meshNum);
+
+		for (int primNum = 0; primNum < PRIMITIVE_COUNT; primNum++)
+		{
+			PrimitiveData* primitive = new PrimitiveData();
+			primitive->material_name_id = GetStringId(primNum == 0 ? "skull_material" : "bone_material");
+			primitive->type = TRIANGLE_LIST;
+			primitive->num_indices = INDEX_COUNT;
+			primitive->index_byte_size = sizeof(UInt16);
+			primitive->indices = malloc(INDEX_COUNT * sizeof(UInt16));
+			UInt16* indices = (UInt16*)primitive->indices;
+			for (int i = 0; i < INDEX_COUNT; i++) indices[i] = (UInt16)((i * 3 + primNum + meshNum) % VERTEX_COUNT);
+			mesh.primitives.push_back(primitive);
+		}
+	}
+
+	// a skeleton puts data in the stream at the end of the file
+	Skeleton* skeleton = new Skeleton();
+	for (int jointNum = 0; jointNum < 4; jointNum++)
+	{
+		Joint joint;
+		joint.name_id = jointNum + 1;
+		joint.inv_bind_pose.SetIdentity();
+		joint.parent = jointNum - 1;
+		skeleton->AddJoint(joint);
+	}
+	_scene.skeletons.push_back(skeleton);
+}
+
+/* Return if two scenes have the same strings, materials, vertices, indices and skeletons
+
+_a - First scene
+_b - Second scene
+*/
+bool sameScene(const Scene& _a, const Scene& _b)
+{
+	if (_a.string_id_table.table() != _b.string_id_table.table()) return false;
+
+	if (_a.material_data.size() != _b.material_data.size()) return false;
+	std::list<MaterialData>::const_iterator materialA = _a.material_data.begin();
+	std::list<MaterialData>::const_iterator materialB = _b.material_data.begin();
+	for (; materialA != _a.material_data.end(); ++materialA, ++materialB)
+	{
+		if (materialA->name_id != materialB->name_id || materialA->colour != materialB->colour || materialA->diffuse_texture != materialB->diffuse_texture) return false;
+	}
+
+	if (_a.mesh_data.size() != _b.mesh_data.size()) return false;
+	std::list<MeshData>::const_iterator meshA = _a.mesh_data.begin();
+	std::list<MeshData>::const_iterator meshB = _b.mesh_data.begin();
+	for (; meshA != _a.mesh_data.end(); ++meshA, ++meshB)
+	{
+		if (meshA->name_id != meshB->name_id) return false;
+		if (meshA->aabb.min_vtx().x() != meshB->aabb.min_vtx().x() || meshA->aabb.max_vtx().z() != meshB->aabb.max_vtx().z()) return false;
+
+		const VertexData& verticesA = meshA->vertex_data;
+		const VertexData& verticesB = meshB->vertex_data;
+		if (verticesA.num_vertices != verticesB.num_vertices || verticesA.vertex_byte_size != verticesB.vertex_byte_size) return false;
+		if (memcmp(verticesA.vertices, verticesB.vertices, verticesA.num_vertices * verticesA.vertex_byte_size) != 0) return false;
+
+		if (meshA->primitives.size() != meshB->primitives.size()) return false;
+		for (size_t primNum = 0; primNum < meshA->primitives.size(); primNum++)
+		{
+			const PrimitiveData* primA = meshA->primitives[primNum];
+			const PrimitiveData* primB = meshB->primitives[primNum];
+			if (primA->material_name_id != primB->material_name_id || primA->type != primB->type) return false;
+			if (primA->num_indices != primB->num_indices || primA->index_byte_size != primB->index_byte_size) return false;
+			if (memcmp(primA->indices, primB->indices, primA->num_indices * primA->index_byte_size) != 0) return false;
+		}
+	}
+
+	if (_a.skeletons.size() != _b.skeletons.size()) return false;
+	std::list<Skeleton*>::const_iterator skeletonA = _a.skeletons.begin();
+	std::list<Skeleton*>::const_iterator skeletonB = _b.skeletons.begin();
+	for (; skeletonA != _a.skeletons.end(); ++skeletonA, ++skeletonB)
+	{
+		const vector<Joint>& jointsA = (*skeletonA)->joints();
+		const vector<Joint>& jointsB = (*skeletonB)->joints();
+		if (jointsA.size() != jointsB.size()) return false;
+		for (size_t jointNum = 0; jointNum < jointsA.size(); jointNum++)
+		{
+			if (jointsA[jointNum].name_id != jointsB[jointNum].name_id || jointsA[jointNum].parent != jointsB[jointNum].parent) return false;
+		}
+	}
+
+	return true;
+}
+
+/* Return the contents of a file, empty if it can't be read
+
+_filename - File to read
+*/
+vector<char> readFile(const std::string& _filename)
+{
+	std::ifstream file(_filename.c_str(), std::ios::binary);
+	return vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/* Write the contents of a file
+
+_filename - File to write
+_data - Bytes to write
+_size - Number of bytes to write
+*/
+void writeFile(const std::string& _filename, const vector<char>& _data, size_t _size)
+{
+	std::ofstream file(_filename.c_str(), std::ios::binary);
+	if (_size > 0) file.write(&_data[0], _size);
+}
+
+/* Write a 32 bit value into a copy of a file's contents
+
+_data - File contents
+_offset - Byte offset of the value
+_value - Value to write
+*/
+void poke(vector<char>& _data, size_t _offset, UInt32 _value)
+{
+	memcpy(&_data[_offset], &_value, sizeof(UInt32));
+}
+
+/* Read a 32 bit value from a file's contents
+
+_data - File contents
+_offset - Byte offset of the value
+*/
+UInt32 peek(const vector<char>& _data, size_t _offset)
+{
+	UInt32 value;
+	memcpy(&value, &_data[_offset], sizeof(UInt32));
+	return value;
+}
+
+/* Check that a bad copy of the scene file fails to read, and leaves an already read scene as it was
+
+_platform - Platform to read the file with
+_filename - Bad scene file
+_expected - Scene holding what was read before the bad file
+_description - What is wrong with the file
+*/
+void checkBadFile(const Platform& _platform, const std::string& _filename, const Scene& _expected, const char* _description)
+{
+	Scene scene;
+	bool good = scene.ReadSceneFromFile(_platform, (_filename + ".good").c_str());
+	bool read = scene.ReadSceneFromFile(_platform, _filename.c_str());
+	check(good && !read && sameScene(scene, _expected), _description);
+}
+
+int main(int argc, char** argv)
+{
+	std::string directory = argc > 1 ? std::string(argv[1]) + "/" : std::string();
+	const std::string sceneFile = directory + "scene_test.scn";
+	const std::string badFile = directory + "scene_test_bad.scn";
+
+	PlatformNull platform;
+
+	Scene source;
+	buildScene(source);
+	check(source.WriteMappedSceneToFile(platform, sceneFile.c_str()), "write mapped scene");
+	check(source.WriteMappedSceneToFile(platform, (badFile + ".good").c_str()), "write mapped scene again");
+
+	// read back
+	const vector<char> fileData = readFile(sceneFile);
+	{
+		Scene scene;
+		check(Scene::IsMappedScene(fileData.empty() ? NULL : &fileData[0], (Int32)fileData.size()), "file is a mapped scene");
+		check(scene.ReadSceneFromFile(platform, sceneFile.c_str()), "read mapped scene");
+		check(sameScene(scene, source), "read back vertices, indices, materials and strings match");
+
+		// mapped vertices point into the file, writing to them must only change this scene's copy
+		MeshData& mesh = scene.mesh_data.front();
+		memset(mesh.vertex_data.vertices, 0, mesh.vertex_data.num_vertices * mesh.vertex_data.vertex_byte_size);
+		check(readFile(sceneFile) == fileData, "writing to mapped vertices leaves the file unchanged");
+	}
+
+	// an already read scene, for the bad files to be compared against
+	Scene expected;
+	expected.ReadSceneFromFile(platform, sceneFile.c_str());
+
+	// truncated files, all still long enough to start with the mapped scene header
+	size_t truncations[] = { HEADER_SIZE, fileData.size() / 2, fileData.size() - 1 };
+	for (size_t i = 0; i < sizeof(truncations) / sizeof(truncations[0]); i++)
+	{
+		char description[64];
+		sprintf(description, "file truncated to %d bytes fails to read", (int)truncations[i]);
+		writeFile(badFile, fileData, truncations[i]);
+		checkBadFile(platform, badFile, expected, description);
+	}
+
+	// a missing file
+	{
+		Scene scene;
+		check(!scene.ReadSceneFromFile(platform, (directory + "scene_test_missing.scn").c_str()) && scene.mesh_data.empty(), "missing file fails to read");
+	}
+
+	// the last mesh's primitives are past the end of the file, so the first meshes are read before it fails
+	{
+		vector<char> corrupt = fileData;
+		UInt32 meshesOffset = peek(corrupt, HEADER_MESHES_OFFSET);
+		poke(corrupt, meshesOffset + (MESH_COUNT - 1) * MESH_RECORD_SIZE + MESH_RECORD_PRIMITIVES_OFFSET, 0x7ffffff0);
+		writeFile(badFile, corrupt, corrupt.size());
+		checkBadFile(platform, badFile, expected, "corrupt primitives offset fails to read");
+	}
+
+	// the string table runs off the end of the file
+	{
+		vector<char> corrupt = fileData;
+		poke(corrupt, HEADER_STRINGS_OFFSET, (UInt32)corrupt.size() - 2);
+		writeFile(badFile, corrupt, corrupt.size());
+		checkBadFile(platform, badFile, expected, "corrupt string table fails to read");
+	}
+
+	// more skeletons than are in the stream
+	{
+		vector<char> corrupt = fileData;
+		poke(corrupt, HEADER_SKELETON_COUNT, peek(corrupt, HEADER_SKELETON_COUNT) + 1);
+		writeFile(badFile, corrupt, corrupt.size());
+		checkBadFile(platform, badFile, expected, "corrupt skeleton count fails to read");
+	}
+
+	// the scene cache returns what it loaded the first time
+	{
+		SceneCache cache(platform);
+		Scene* scene = cache.LoadScene(sceneFile.c_str());
+		check(scene != NULL && scene->meshes.size() == MESH_COUNT, "scene cache loads the scene and its meshes");
+		check(cache.LoadScene(sceneFile.c_str()) == scene, "second LoadScene returns the same scene");
+
+		Mesh* mesh = cache.LoadMesh(sceneFile.c_str());
+		check(mesh != NULL && scene != NULL && mesh == scene->meshes.front(), "LoadMesh returns the scene's first mesh");
+		check(cache.LoadMesh(sceneFile.c_str()) == mesh, "second LoadMesh returns the same mesh");
+		check(cache.num_scenes() == 1, "scene cache holds one scene");
+
+		const std::string missingFile = directory + "scene_test_missing.scn";
+		check(cache.LoadScene(missingFile.c_str()) == NULL && cache.LoadMesh(missingFile.c_str()) == NULL, "scene cache returns NULL for a missing file");
+	}
+
+	remove(sceneFile.c_str());
+	remove(badFile.c_str());
+	remove((badFile + ".good").c_str());
+
+	printf("%s\n", failures == 0 ? "all checks passed" : "FAILED");
+	return failures == 0 ? 0 : 1;
+}
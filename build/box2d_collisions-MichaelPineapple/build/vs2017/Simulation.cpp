@@ -1,11 +1,59 @@
 #include "Nexus.h"
 
-// List of entities (MclObjects) in the physics simulation
-vector<MclObject*> entityList = vector<MclObject*>();
+// Pooled storage for the entities (MclObjects) in the physics simulation
+EntityStore entityStore;
 
 // THE WORLD!!
 b2World* world;
 
+// Contact events recorded during the last world step. Capacity is kept between steps so recording does not allocate.
+const int CONTACT_EVENT_CAPACITY = 4096;
+vector<ContactEvent> contactEvents = vector<ContactEvent>();
+
+/* Record a contact event into 'contactEvents'
+
+_contact - The Box2D contact which began or ended
+_eventType - If the contact began or ended
+*/
+void recordContactEvent(b2Contact* _contact, ContactEventType _eventType)
+{
+	b2Body* bodyA = _contact->GetFixtureA()->GetBody();
+	b2Body* bodyB = _contact->GetFixtureB()->GetBody();
+	int indexA = entityStore.indexOf(bodyA);
+	int indexB = entityStore.indexOf(bodyB);
+	if (indexA < 0 || indexB < 0) return;
+
+	ContactEvent contactEvent;
+	contactEvent.eventType = _eventType;
+	contactEvent.bodyA = bodyA;
+	contactEvent.bodyB = bodyB;
+	contactEvent.typeA = entityStore.getTypes()[indexA];
+	contactEvent.typeB = entityStore.getTypes()[indexB];
+	contactEvent.approachSpeed = 0.0f;
+
+	// measure how fast the bodies were moving into each other at the first contact point
+	if (_eventType == CONTACT_BEGIN && _contact->GetManifold()->pointCount > 0)
+	{
+		b2WorldManifold worldManifold;
+		_contact->GetWorldManifold(&worldManifold);
+		b2Vec2 velA = bodyA->GetLinearVelocityFromWorldPoint(worldManifold.points[0]);
+		b2Vec2 velB = bodyB->GetLinearVelocityFromWorldPoint(worldManifold.points[0]);
+		contactEvent.approachSpeed = b2Dot(velA - velB, worldManifold.normal);
+	}
+
+	contactEvents.push_back(contactEvent);
+}
+
+/* ContactRecorder class, Box2D contact listener which fills 'contactEvents' while the world steps.
+Bodies cannot be modified inside these callbacks, so events are handled after the step instead.
+*/
+class ContactRecorder : public b2ContactListener
+{
+	void BeginContact(b2Contact* _contact) { recordContactEvent(_contact, CONTACT_BEGIN); }
+	void EndContact(b2Contact* _contact) { recordContactEvent(_contact, CONTACT_END); }
+};
+ContactRecorder contactRecorder;
+
 /* Initialize the simulation
 
 _platform - Current application platform.
@@ -14,10 +62,15 @@ _gravity - Gavity Y value for the Box2D physics simulation.
 void Simulation::INITIALIZE(Platform& _platform, float _gravity)
 {
 	world = new b2World(b2Vec2(0.0f, _gravity));
-	entityList = vector<MclObject*>();
+	world->SetContactListener(&contactRecorder);
+	entityStore.clear();
+	contactEvents.clear();
+	contactEvents.reserve(CONTACT_EVENT_CAPACITY);
 }
 
-/* Return a new MclObject given some creation info
+/* Return a new MclObject given some creation info.
+The MclObject is owned and recycled by the simulation once it is passed to 'ADD_ENTITY', which every created object must be.
+Entities without a mesh share a cached box mesh of their size.
 
 _position - Starting position of the MclObject
 _size - Size of the MclObject
@@ -27,23 +80,23 @@ _mesh - Mesh of the MclObject (Optional)
 */
 MclObject* Simulation::CREATE_ENTITY(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType)
 {
-	return new MclObject(_position, _size, _dynamic, _entityType, Nexus::GET_PRIMITIVE_BUILDER()->CreateBoxMesh(Vector4(_size.x/2.0f, _size.y/2.0f, 0.25f)), world);
+	return CREATE_ENTITY(_position, _size, _dynamic, _entityType, entityStore.getBoxMesh(_size, Nexus::GET_PRIMITIVE_BUILDER()));
 }
 MclObject* Simulation::CREATE_ENTITY(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType, Mesh* _mesh)
 {
-	return new MclObject(_position, _size, _dynamic, _entityType, _mesh, world);
+	return entityStore.createObject(_position, _size, _dynamic, _entityType, _mesh, world);
 }
 
-/* Add a new MclObject to the simulation
+/* Add a new MclObject to the simulation and return a handle to it
 
 _obj - The MclObject to add.
 */
-void Simulation::ADD_ENTITY(MclObject* _obj)
+EntityHandle Simulation::ADD_ENTITY(MclObject* _obj)
 {
-	entityList.push_back(_obj);
+	return entityStore.add(_obj);
 }
 
-/* Create and add a new MclObject to the simulation given some creation info
+/* Create and add a new MclObject to the simulation given some creation info, return a handle to it
 
 _position - Starting position of the MclObject
 _size - Size of the MclObject
@@ -51,13 +104,36 @@ _dynamic - If the MclObject should be affected by the Box2D physics
 _entityType - The type of entity this MclObject is.
 _mesh - Mesh of the MclObject (Optional)
 */
-void Simulation::ADD_ENTITY(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType)
+EntityHandle Simulation::ADD_ENTITY(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType)
 {
-	ADD_ENTITY(CREATE_ENTITY(_position, _size, _dynamic, _entityType));
+	return ADD_ENTITY(CREATE_ENTITY(_position, _size, _dynamic, _entityType));
 }
-void Simulation::ADD_ENTITY(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType, Mesh* _mesh)
+EntityHandle Simulation::ADD_ENTITY(b2Vec2 _position, b2Vec2 _size, bool _dynamic, ObjectType _entityType, Mesh* _mesh)
 {
-	ADD_ENTITY(CREATE_ENTITY(_position, _size, _dynamic, _entityType, _mesh));
+	return ADD_ENTITY(CREATE_ENTITY(_position, _size, _dynamic, _entityType, _mesh));
+}
+
+/* Remove an entity from the simulation and destroy its body, does nothing if the entity was already removed.
+Any contact events from the last step involving the entity are dropped, its MclObject is recycled by later 'CREATE_ENTITY' calls.
+Must not be called from the collision callback given to 'UPDATE'.
+
+_handle - Handle returned when the entity was added
+*/
+void Simulation::REMOVE_ENTITY(EntityHandle _handle)
+{
+	int index = entityStore.indexOf(_handle);
+	if (!world || index < 0) return;
+
+	// drop the events which would otherwise hold on to the destroyed body
+	b2Body* body = entityStore.getObject(index)->getBody();
+	int kept = 0;
+	for (int i = 0; i < contactEvents.size(); i++)
+	{
+		if (contactEvents[i].bodyA != body && contactEvents[i].bodyB != body) contactEvents[kept++] = contactEvents[i];
+	}
+	contactEvents.resize(kept);
+
+	entityStore.remove(_handle, world);
 }
 
 /* Internal function to update the simulation */
@@ -65,67 +141,76 @@ void update()
 {
 	if (world)
 	{
-		// Update THE WORLD
+		// Update THE WORLD, the contact recorder fills 'contactEvents' during the step
 		float timeStep = 1.0f / 60.0f;
 		int32 velocityIterations = 6;
 		int32 positionIterations = 2;
+		contactEvents.clear();
 		world->Step(timeStep, velocityIterations, positionIterations);
 
-		// Update all entities
-		for (int i = 0; i < entityList.size(); i++)
-		{
-			entityList[i]->updateFromSimulation();
-
-			// increment the collide cooldown for each entity (used for better collision handling)
-			GameObject* obj = (GameObject*)entityList[i]->getBody()->GetUserData();
-			obj->collideCooldown++;
-		}
+		// Copy the new body positions into the entity arrays and world matrices in one pass
+		entityStore.syncFromBodies();
 	}
 }
 
 /* Global function to update the simulation
 
-_onCollide - Callback function when two Box2D bodies collide (Optional.)
+_onCollide - Callback function called once for each pair of Box2D bodies which started touching this step (Optional.)
 */
-void Simulation::UPDATE(void (*_onCollide)(b2Body*, b2Body*))
+void Simulation::UPDATE(void (*_onCollide)(const ContactEvent&))
 {
+	GEF_PROFILE_ZONE("Simulation::UPDATE");
 	update();
 
-	if (world)
+	for (int i = 0; i < contactEvents.size(); i++)
 	{
-		b2Contact* contact = world->GetContactList();
-		int contact_count = world->GetContactCount();
-		for (int contact_num = 0; contact_num < contact_count; ++contact_num)
-		{
-			if (contact->IsTouching()) _onCollide(contact->GetFixtureA()->GetBody(), contact->GetFixtureB()->GetBody());
-			contact = contact->GetNext();
-		}
+		if (contactEvents[i].eventType == CONTACT_BEGIN) _onCollide(contactEvents[i]);
 	}
 }
 void Simulation::UPDATE()
 {
+	GEF_PROFILE_ZONE("Simulation::UPDATE");
 	update();
 }
 
 /* Render the simulation */
 void Simulation::RENDER()
 {
-	for (int i = 0; i < entityList.size(); i++) Nexus::DRAW_MCLOBJ(entityList[i]);
+	const Matrix44* transforms = entityStore.getTransforms();
+	for (int i = 0; i < entityStore.size(); i++) Nexus::DRAW_MCLOBJ(entityStore.getObject(i), transforms[i]);
 }
 
-/* Unload all entities and clean the simulation */
+/* Unload all entities and clean the simulation, the entities' MclObjects are kept for reuse */
 void Simulation::CLEAN()
 {
 	delete world;
 	world = NULL;
 
+	for (int i = 0; i < entityStore.size(); i++) entityStore.getObject(i)->clean();
+	entityStore.clear();
+	contactEvents.clear();
+}
 
-	for (int i = 0; i < entityList.size(); i++) entityList[i]->clean();
-	entityList.clear();
+/* Delete all pooled MclObjects and box meshes, called once when the application shuts down */
+void Simulation::RELEASE()
+{
+	entityStore.release();
+}
+
+/* Return a reference to the store of all entities within the simulation */
+const EntityStore& Simulation::GET_ENTITIES()
+{
+	return entityStore;
+}
+
+/* Return the contact events recorded during the last simulation step */
+const vector<ContactEvent>& Simulation::GET_CONTACT_EVENTS()
+{
+	return contactEvents;
 }
 
-/* Return a reference to the list of all entities within the simulation */
-vector<MclObject*> Simulation::GET_ENTITIES()
+/* Return the Box2D world of the simulation, NULL if it has not been initialized */
+b2World* Simulation::GET_WORLD()
 {
-	return entityList;
+	return world;
 }
\ No newline at end of file
@@ -0,0 +1,303 @@
+#include "Nexus.h"
+#include <platform/null/system/platform_null.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <algorithm>
+
+/* Headless stress benchmark for the PLAY game state.
+
+Runs the Box2D simulation with the real PlayState collision rules against a large number of skulls,
+using the gef null platform so no window, graphics device or audio device is needed.
+
+Usage: stress_bench [seed] [skulls] [frames] [csv_file] [solver_threads] [trace_file] [churn]
+Pass - as the csv_file to skip writing it. solver_threads is given to b2World::SetSolverThreadCount.
+Giving a trace_file turns the profiler on and writes every frame to it as a Chrome trace.
+churn is the number of skulls removed and spawned again every 60 frames, checking that removed entities are gone
+and their objects are reused.
+*/
+
+// Number of heap allocations made through operator new since the program started
+static unsigned long long allocationCount = 0;
+
+void* operator new(size_t _size)
+{
+	allocationCount++;
+	Profiler::CountAllocation(_size);
+	void* mem = malloc(_size ? _size : 1);
+	if (!mem) throw std::bad_alloc();
+	return mem;
+}
+
+void* operator new[](size_t _size)
+{
+	allocationCount++;
+	Profiler::CountAllocation(_size);
+	void* mem = malloc(_size ? _size : 1);
+	if (!mem) throw std::bad_alloc();
+	return mem;
+}
+
+void operator delete(void* _mem) noexcept
+{
+	if (_mem) Profiler::CountFree();
+	free(_mem);
+}
+
+void operator delete[](void* _mem) noexcept
+{
+	if (_mem) Profiler::CountFree();
+	free(_mem);
+}
+
+// Measurements taken for a single simulation frame
+struct FrameStats
+{
+	float stepMs;
+	b2Profile profile;
+	int contacts;
+	int touchingContacts;
+	int beginEvents;
+	unsigned long long allocations;
+	float renderMs;
+	gef::Renderer3DStats render;
+};
+
+/* Return the average of a value over all frames
+
+_frames - Recorded frame stats
+_value - Function which extracts the value from a frame
+*/
+template <typename T>
+double average(const vector<FrameStats>& _frames, T _value)
+{
+	double total = 0.0;
+	for (size_t i = 0; i < _frames.size(); i++) total += _value(_frames[i]);
+	return _frames.empty() ? 0.0 : total / _frames.size();
+}
+
+/* Return the given percentile (0-100) of the step times
+
+_frames - Recorded frame stats
+_percentile - Percentile to return
+*/
+float stepPercentile(const vector<FrameStats>& _frames, float _percentile)
+{
+	if (_frames.empty()) return 0.0f;
+	vector<float> times;
+	times.reserve(_frames.size());
+	for (size_t i = 0; i < _frames.size(); i++) times.push_back(_frames[i].stepMs);
+	std::sort(times.begin(), times.end());
+	size_t index = (size_t)((_percentile / 100.0f) * (times.size() - 1) + 0.5f);
+	return times[index];
+}
+
+/* Write the per frame stats as CSV
+
+_filename - File to write to
+_frames - Recorded frame stats
+*/
+void writeCsv(const char* _filename, const vector<FrameStats>& _frames)
+{
+	FILE* file = fopen(_filename, "w");
+	if (!file)
+	{
+		printf("Failed to open '%s' for writing\n", _filename);
+		return;
+	}
+
+	fprintf(file, "frame,step_ms,b2_step,b2_collide,b2_solve,b2_solve_init,b2_solve_velocity,b2_solve_position,b2_broadphase,b2_solve_toi,contacts,touching,begin_events,allocations,render_ms,draw_calls,state_changes,instances\n");
+	for (size_t i = 0; i < _frames.size(); i++)
+	{
+		const FrameStats& f = _frames[i];
+		fprintf(file, "%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%d,%d,%d,%llu,%.4f,%d,%d,%d\n", (int)i, f.stepMs,
+			f.profile.step, f.profile.collide, f.profile.solve, f.profile.solveInit, f.profile.solveVelocity,
+			f.profile.solvePosition, f.profile.broadphase, f.profile.solveTOI,
+			f.contacts, f.touchingContacts, f.beginEvents, f.allocations,
+			f.renderMs, f.render.draw_calls, f.render.state_changes, f.render.instances);
+	}
+
+	fclose(file);
+}
+
+/* Remove random skulls from the simulation and spawn new ones in their place.
+Returns false if a removed entity is still in the store, its MclObject was not reused,
+or a contact event still refers to a body which is not an entity.
+
+_count - Number of skulls to replace
+*/
+bool replaceSkulls(int _count)
+{
+	const EntityStore& entities = Simulation::GET_ENTITIES();
+	int sizeBefore = entities.size();
+	bool ok = true;
+
+	for (int i = 0; i < _count; i++)
+	{
+		// pick a random skull, the walls and the player are never removed
+		int index = rand() % entities.size();
+		if (entities.getTypes()[index] != ENEMY) continue;
+
+		EntityHandle handle = entities.handleOf(index);
+		MclObject* removed = entities.getObject(index);
+		Simulation::REMOVE_ENTITY(handle);
+		if (entities.isValid(handle) || removed->getBody() != NULL) ok = false;
+
+		// the pool hands out the most recently removed object first
+		EntityHandle spawned = PlayState::SPAWN_SKULL();
+		if (entities.getObject(entities.indexOf(spawned)) != removed) ok = false;
+	}
+	if (entities.size() != sizeBefore) ok = false;
+
+	const vector<ContactEvent>& events = Simulation::GET_CONTACT_EVENTS();
+	for (size_t i = 0; i < events.size(); i++)
+	{
+		if (entities.indexOf(events[i].bodyA) < 0 || entities.indexOf(events[i].bodyB) < 0) ok = false;
+	}
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	// read the benchmark settings from the command line
+	unsigned int seed = argc > 1 ? (unsigned int)atoi(argv[1]) : 1;
+	int skullCount = argc > 2 ? atoi(argv[2]) : 2000;
+	int frameCount = argc > 3 ? atoi(argv[3]) : 600;
+	const char* csvFilename = argc > 4 && strcmp(argv[4], "-") != 0 ? argv[4] : NULL;
+	int solverThreads = argc > 5 ? atoi(argv[5]) : 1;
+	const char* traceFilename = argc > 6 && strcmp(argv[6], "-") != 0 ? argv[6] : NULL;
+	int churn = argc > 7 ? atoi(argv[7]) : 0;
+
+	gef::PlatformNull platform;
+	gef::Renderer3D* renderer3d = gef::Renderer3D::Create(platform);
+	Nexus::INITIALIZE_HEADLESS(platform, renderer3d);
+
+	// seed after initialization so the skull layout only depends on the given seed
+	srand(seed);
+	Simulation::INITIALIZE(platform, -3.0f);
+	PlayState::CREATE_ARENA(skullCount);
+
+	b2World* world = Simulation::GET_WORLD();
+	world->SetSolverThreadCount(solverThreads > 1 ? solverThreads : 1);
+	vector<FrameStats> frames;
+	frames.reserve(frameCount);
+
+	// each profiler frame is one pass of the loop below
+	Profiler::NextFrame();
+	if (traceFilename)
+	{
+		Profiler::SetEnabled(true);
+		Profiler::CaptureTrace(traceFilename, frameCount);
+	}
+
+	int replacedSkulls = 0;
+	bool replaceFailed = false;
+	for (int frame = 0; frame < frameCount; frame++)
+	{
+		FrameStats stats;
+		unsigned long long allocationsBefore = allocationCount;
+
+		// time one PLAY frame worth of simulation
+		b2Timer timer;
+		Simulation::UPDATE(PlayState::ON_COLLIDE);
+		PlayState::RESET_FALLEN_SKULLS();
+		stats.stepMs = timer.GetMilliseconds();
+
+		stats.allocations = allocationCount - allocationsBefore;
+		stats.profile = world->GetProfile();
+		stats.contacts = world->GetContactCount();
+		stats.touchingContacts = 0;
+		for (b2Contact* contact = world->GetContactList(); contact; contact = contact->GetNext())
+		{
+			if (contact->IsTouching()) stats.touchingContacts++;
+		}
+
+		// count the new impacts the gameplay code was given this frame
+		const vector<ContactEvent>& events = Simulation::GET_CONTACT_EVENTS();
+		stats.beginEvents = 0;
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			if (events[i].eventType == CONTACT_BEGIN) stats.beginEvents++;
+		}
+
+		// replace some skulls once a second, after the step so there are contact events to drop
+		if (churn > 0 && frame % 60 == 59)
+		{
+			if (!replaceSkulls(churn)) replaceFailed = true;
+			replacedSkulls += churn;
+		}
+
+		// submit the frame to the counting null renderer
+		b2Timer renderTimer;
+		renderer3d->Begin();
+		Simulation::RENDER();
+		renderer3d->End();
+		stats.renderMs = renderTimer.GetMilliseconds();
+		stats.render = renderer3d->stats();
+
+		frames.push_back(stats);
+		Profiler::NextFrame();
+	}
+
+	// report the results
+	printf("stress_bench seed=%u skulls=%d frames=%d solver_threads=%d bodies=%d\n", seed, skullCount, frameCount, world->GetSolverThreadCount(), world->GetBodyCount());
+	printf("step ms      avg %8.4f  min %8.4f  p50 %8.4f  p95 %8.4f  max %8.4f\n",
+		average(frames, [](const FrameStats& f) { return f.stepMs; }),
+		stepPercentile(frames, 0.0f), stepPercentile(frames, 50.0f), stepPercentile(frames, 95.0f), stepPercentile(frames, 100.0f));
+	printf("b2Profile ms step %.4f  collide %.4f  solve %.4f  (init %.4f  velocity %.4f  position %.4f)  broadphase %.4f  toi %.4f\n",
+		average(frames, [](const FrameStats& f) { return f.profile.step; }),
+		average(frames, [](const FrameStats& f) { return f.profile.collide; }),
+		average(frames, [](const FrameStats& f) { return f.profile.solve; }),
+		average(frames, [](const FrameStats& f) { return f.profile.solveInit; }),
+		average(frames, [](const FrameStats& f) { return f.profile.solveVelocity; }),
+		average(frames, [](const FrameStats& f) { return f.profile.solvePosition; }),
+		average(frames, [](const FrameStats& f) { return f.profile.broadphase; }),
+		average(frames, [](const FrameStats& f) { return f.profile.solveTOI; }));
+	printf("contacts     avg %.1f  touching %.1f  begin events %.1f\n",
+		average(frames, [](const FrameStats& f) { return f.contacts; }),
+		average(frames, [](const FrameStats& f) { return f.touchingContacts; }),
+		average(frames, [](const FrameStats& f) { return f.beginEvents; }));
+	printf("allocations  avg %.1f per frame\n",
+		average(frames, [](const FrameStats& f) { return (double)f.allocations; }));
+
+	printf("render ms    avg %.4f  draw calls %.1f  state changes %.1f  instances %.1f\n",
+		average(frames, [](const FrameStats& f) { return f.renderMs; }),
+		average(frames, [](const FrameStats& f) { return f.render.draw_calls; }),
+		average(frames, [](const FrameStats& f) { return f.render.state_changes; }),
+		average(frames, [](const FrameStats& f) { return f.render.instances; }));
+
+	// the slowest zones over the last few frames, when the profiler was on
+	const gef::ProfileSummary& profile = Profiler::summary();
+	if (profile.num_frames > 0)
+	{
+		printf("profiler     last %d frames  frame %.4f ms  allocs %.1f (%.1f KB)  frees %.1f  dropped zones %llu\n", profile.num_frames,
+			profile.frame_ms, profile.allocations, profile.allocated_kb, profile.frees, (unsigned long long)profile.dropped_zones);
+		for (size_t i = 0; i < profile.zones.size(); i++)
+			printf("  %-28s %8.4f ms  %6.1f calls\n", profile.zones[i].name, profile.zones[i].ms, profile.zones[i].calls);
+	}
+	if (traceFilename) printf("trace written to %s\n", traceFilename);
+
+	if (csvFilename) writeCsv(csvFilename, frames);
+
+	if (churn > 0) printf("churn        up to %d skulls removed and spawned again  %s\n", replacedSkulls, replaceFailed ? "FAILED" : "ok");
+
+	// every skull shares one mesh, so batched submission must draw far fewer times than there are instances
+	int result = replaceFailed ? 1 : 0;
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		if (frames[i].render.instances > 1 && frames[i].render.draw_calls >= frames[i].render.instances)
+		{
+			printf("FAILED: frame %d issued %d draw calls for %d instances\n", (int)i, frames[i].render.draw_calls, frames[i].render.instances);
+			result = 1;
+			break;
+		}
+	}
+
+	// clean up
+	Simulation::CLEAN();
+	Nexus::CLEAN();
+	delete renderer3d;
+
+	return result;
+}
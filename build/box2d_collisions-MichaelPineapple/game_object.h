@@ -2,7 +2,7 @@
 #define _GAME_OBJECT_H
 
 #include <graphics/mesh_instance.h>
-#include <box2d/Box2D.h>
+#include <box2d/box2d.h>
 
 // Enum to denote entity type. Used for collision events.
 enum ObjectType
@@ -19,7 +19,6 @@ class GameObject : public gef::MeshInstance
 public:
 	void UpdateFromSimulation(const b2Body* body);
 	ObjectType type_;
-	int collideCooldown = 0;
 };
 
 #endif // _GAME_OBJECT_H
\ No newline at end of file
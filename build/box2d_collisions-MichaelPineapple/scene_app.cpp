@@ -1,6 +1,8 @@
 #include "Nexus.h"
 #include "scene_app.h"
 #include <maths/math_utils.h>
+#include <cstdlib>
+#include <new>
 using gef::Vector4;
 using gef::Default3DShaderData;
 using gef::Matrix44;
@@ -14,6 +16,37 @@ InputManager* inputManager;
 // frames per second
 float fps = 0;
 
+#ifdef GEF_PROFILER
+// Count every heap allocation for the profiler, see the allocation counters in the profiler summary and trace files
+void* operator new(size_t _size)
+{
+	Profiler::CountAllocation(_size);
+	void* mem = malloc(_size ? _size : 1);
+	if (!mem) throw std::bad_alloc();
+	return mem;
+}
+
+void* operator new[](size_t _size)
+{
+	Profiler::CountAllocation(_size);
+	void* mem = malloc(_size ? _size : 1);
+	if (!mem) throw std::bad_alloc();
+	return mem;
+}
+
+void operator delete(void* _mem) noexcept
+{
+	if (_mem) Profiler::CountFree();
+	free(_mem);
+}
+
+void operator delete[](void* _mem) noexcept
+{
+	if (_mem) Profiler::CountFree();
+	free(_mem);
+}
+#endif
+
 /* Setup lighting for the 3D scene
 
 _renderer3D - Object used to render 3d meshes
@@ -75,6 +108,9 @@ _frameTime - Elapsed time of the previous frame
 */
 bool SceneApp::Update(float _frameTime)
 {
+	// the profiler's frames run from the start of one update to the start of the next, so they include rendering
+	Profiler::NextFrame();
+
 	// calculate frames per second
 	fps = 1.0f / _frameTime;
 
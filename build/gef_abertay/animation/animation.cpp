@@ -173,7 +173,7 @@ namespace gef
 		// name_id and type have already been read so don't read them in here
 
 		// scale
-		Int32 num_scale_keys;
+		Int32 num_scale_keys = 0;
 		stream.read((char*)&num_scale_keys, sizeof(Int32));
 		if(num_scale_keys > 0)
 		{
@@ -181,7 +181,7 @@ namespace gef
 			stream.read((char*)&scale_keys_.front(), sizeof(Vector3Key)*num_scale_keys);
 		}
 		// rotate
-		Int32 num_rotation_keys;
+		Int32 num_rotation_keys = 0;
 		stream.read((char*)&num_rotation_keys, sizeof(Int32));
 		if(num_rotation_keys > 0)
 		{
@@ -189,14 +189,14 @@ namespace gef
 			stream.read((char*)&rotation_keys_.front(), sizeof(QuaternionKey)*num_rotation_keys);
 		}
 		// translate
-		Int32 num_translation_keys;
+		Int32 num_translation_keys = 0;
 		stream.read((char*)&num_translation_keys, sizeof(Int32));
 		if(num_translation_keys > 0)
 		{
 			translation_keys_.resize(num_translation_keys);
 			stream.read((char*)&translation_keys_.front(), sizeof(Vector3Key)*num_translation_keys);
 		}
-		return true;
+		return !stream.fail();
 	}
 
 	bool TransformAnimNode::Write(std::ostream& stream) const
@@ -288,14 +288,14 @@ namespace gef
 	{
 		// name_id and type have already been read so don't read them in here
 
-		Int32 num_keys;
+		Int32 num_keys = 0;
 		stream.read((char*)&num_keys, sizeof(Int32));
 		if(num_keys > 0)
 		{
 			keys_.resize(num_keys);
 			stream.read((char*)&keys_.front(), sizeof(ChannelKey)*num_keys);
 		}
-		return true;
+		return !stream.fail();
 	}
 
 	bool ChannelAnimNode::Write(std::ostream& stream) const
@@ -398,9 +398,9 @@ namespace gef
 		stream.read((char*)&start_time_, sizeof(float));
 		stream.read((char*)&end_time_, sizeof(float));
 
-		Int32 num_anim_nodes;
+		Int32 num_anim_nodes = 0;
 		stream.read((char*)&num_anim_nodes, sizeof(Int32));
-		bool success = true;
+		bool success = !stream.fail();
 
 		for(Int32 anim_node_num=0; anim_node_num < num_anim_nodes; ++anim_node_num)
 		{
@@ -409,6 +409,11 @@ namespace gef
 
 			stream.read((char*)&name_id, sizeof(StringId));
 			stream.read((char*)&type, sizeof(AnimNode::Type));
+			if(stream.fail())
+			{
+				success = false;
+				break;
+			}
 
 			AnimNode* anim_node = NULL;
 			switch(type)
@@ -422,10 +427,20 @@ namespace gef
 				break;
 			}
 
+			// an unknown node type means the data is bad
+			if(!anim_node)
+			{
+				success = false;
+				break;
+			}
+
 			anim_node->set_name_id(name_id);
 			success = anim_node->Read(stream);
 			if(!success)
+			{
+				delete anim_node;
 				break;
+			}
 
 			AddNode(anim_node);
 		}
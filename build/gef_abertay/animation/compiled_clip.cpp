@@ -0,0 +1,364 @@
+#include <animation/compiled_clip.h>
+#include <animation/animation.h>
+#include <animation/skeleton.h>
+#include <system/profiler.h>
+#include <algorithm>
+
+namespace gef
+{
+	// number of poses a thread takes from the batch at a time
+	static const Int32 kClipBatchChunkSize = 8;
+
+	ClipCursor::ClipCursor() :
+		last_time_(0.0f),
+		clip_(NULL)
+	{
+	}
+
+	void ClipCursor::Reset()
+	{
+		next_keys_.clear();
+		last_time_ = 0.0f;
+		clip_ = NULL;
+	}
+
+	CompiledClip::CompiledClip() :
+		skeleton_(NULL),
+		duration_(0.0f),
+		start_time_(0.0f),
+		end_time_(0.0f)
+	{
+	}
+
+	void CompiledClip::Compile(const Animation& animation, const SkeletonPose& bind_pose)
+	{
+		skeleton_ = bind_pose.skeleton();
+		bind_pose_ = bind_pose.local_pose();
+		duration_ = animation.duration();
+		start_time_ = animation.start_time();
+		end_time_ = animation.end_time();
+
+		const Int32 num_joints = (Int32)bind_pose_.size();
+		animated_.assign(num_joints, 0);
+		tracks_.clear();
+		tracks_.reserve(num_joints*kNumTrackTypes);
+		key_times_.clear();
+		key_x_.clear();
+		key_y_.clear();
+		key_z_.clear();
+		key_w_.clear();
+
+		for(Int32 joint_index = 0; joint_index < num_joints; ++joint_index)
+		{
+			const AnimNode* anim_node = skeleton_ ? animation.FindNode(skeleton_->joint(joint_index).name_id) : NULL;
+			const TransformAnimNode* transform_node = NULL;
+			if(anim_node && anim_node->type() == AnimNode::kTransform)
+				transform_node = static_cast<const TransformAnimNode*>(anim_node);
+
+			// nodes found by joint name are always transforms, anything else gets the bind pose
+			animated_[joint_index] = transform_node != NULL;
+
+			if(transform_node)
+			{
+				const std::vector<QuaternionKey>& rotation_keys = transform_node->rotation_keys();
+				AddTrack((Int32)rotation_keys.size());
+				for(std::vector<QuaternionKey>::const_iterator key = rotation_keys.begin(); key != rotation_keys.end(); ++key)
+				{
+					key_times_.push_back(key->time);
+					key_x_.push_back(key->value.x);
+					key_y_.push_back(key->value.y);
+					key_z_.push_back(key->value.z);
+					key_w_.push_back(key->value.w);
+				}
+
+				const std::vector<Vector3Key>& translation_keys = transform_node->translation_keys();
+				AddTrack((Int32)translation_keys.size());
+				for(std::vector<Vector3Key>::const_iterator key = translation_keys.begin(); key != translation_keys.end(); ++key)
+				{
+					key_times_.push_back(key->time);
+					key_x_.push_back(key->value.x());
+					key_y_.push_back(key->value.y());
+					key_z_.push_back(key->value.z());
+					key_w_.push_back(key->value.w());
+				}
+			}
+			else
+			{
+				AddTrack(0);
+				AddTrack(0);
+			}
+		}
+
+#ifdef REMOVE_BIND_POSE
+		inv_joint_orients_.resize(num_joints);
+		for(Int32 joint_index = 0; joint_index < num_joints; ++joint_index)
+		{
+			inv_joint_orients_[joint_index].Inverse(bind_pose_[joint_index].GetMatrix());
+			inv_joint_orients_[joint_index].SetTranslation(gef::Vector4(0.f, 0.f, 0.f));
+		}
+#endif
+	}
+
+	void CompiledClip::AddTrack(const Int32 num_keys)
+	{
+		Track track;
+		track.first_key = (Int32)key_times_.size();
+		track.num_keys = num_keys;
+		tracks_.push_back(track);
+	}
+
+	Int32 CompiledClip::FindNextKey(const Track& track, const float time, const Int32 start_key) const
+	{
+		const float* key_times = &key_times_[track.first_key];
+
+		// without a key to start from, search the whole track
+		if(start_key < 0)
+			return (Int32)(std::upper_bound(key_times, key_times + track.num_keys, time) - key_times);
+
+		// step forwards from the last key used, the next key is usually the same one or the one after
+		Int32 next_key = start_key;
+		while(next_key < track.num_keys && key_times[next_key] <= time)
+			++next_key;
+
+		return next_key;
+	}
+
+	const Quaternion CompiledClip::SampleRotation(const Track& track, const Int32 next_key, const float time) const
+	{
+		// same results as TransformAnimNode::GetRotation
+		const Int32 key = track.first_key + (next_key < track.num_keys ? next_key : track.num_keys-1);
+		const Quaternion next_value(key_x_[key], key_y_[key], key_z_[key], key_w_[key]);
+		if(next_key == 0 || next_key == track.num_keys)
+			return next_value;
+
+		const Int32 prev = key-1;
+		const Quaternion prev_value(key_x_[prev], key_y_[prev], key_z_[prev], key_w_[prev]);
+		const float t = (time - key_times_[prev]) / (key_times_[key] - key_times_[prev]);
+
+		Quaternion result;
+		result.Slerp(prev_value, next_value, t);
+		return result;
+	}
+
+	const Vector4 CompiledClip::SampleTranslation(const Track& track, const Int32 next_key, const float time) const
+	{
+		// same results as TransformAnimNode::GetVector
+		const Int32 key = track.first_key + (next_key < track.num_keys ? next_key : track.num_keys-1);
+		const Vector4 next_value(key_x_[key], key_y_[key], key_z_[key], key_w_[key]);
+		if(next_key == 0 || next_key == track.num_keys)
+			return next_value;
+
+		const Int32 prev = key-1;
+		const Vector4 prev_value(key_x_[prev], key_y_[prev], key_z_[prev], key_w_[prev]);
+		const float t = (time - key_times_[prev]) / (key_times_[key] - key_times_[prev]);
+
+		Vector4 result(0.f, 0.f, 0.f);
+		result.Lerp(prev_value, next_value, t);
+		return result;
+	}
+
+	void CompiledClip::Evaluate(const float time, ClipCursor* cursor, std::vector<JointPose>& local_pose) const
+	{
+		const Int32 num_joints = (Int32)bind_pose_.size();
+		const Int32 num_tracks = (Int32)tracks_.size();
+		if((Int32)local_pose.size() != num_joints)
+			local_pose.resize(num_joints);
+
+		// a cursor that was used with another clip, or for an earlier time, has to search from the first key
+		bool search_from_start = true;
+		if(cursor)
+		{
+			if(cursor->clip_ == this && (Int32)cursor->next_keys_.size() == num_tracks && time >= cursor->last_time_)
+			{
+				search_from_start = false;
+			}
+			else
+			{
+				cursor->clip_ = this;
+				cursor->next_keys_.assign(num_tracks, 0);
+			}
+			cursor->last_time_ = time;
+		}
+
+		for(Int32 joint_index = 0; joint_index < num_joints; ++joint_index)
+		{
+			JointPose& joint_pose = local_pose[joint_index];
+			const JointPose& joint_bind_pose = bind_pose_[joint_index];
+
+			if(animated_[joint_index])
+			{
+				joint_pose.set_scale(gef::Vector4(1.f, 1.f, 1.f));
+
+				const Int32 rotation_track_index = joint_index*kNumTrackTypes + kRotationTrack;
+				const Track& rotation_track = tracks_[rotation_track_index];
+				if(rotation_track.num_keys > 0)
+				{
+					const Int32 next_key = FindNextKey(rotation_track, time, search_from_start ? -1 : cursor->next_keys_[rotation_track_index]);
+					if(cursor)
+						cursor->next_keys_[rotation_track_index] = next_key;
+
+					joint_pose.set_rotation(SampleRotation(rotation_track, next_key, time));
+				}
+				else
+					joint_pose.set_rotation(joint_bind_pose.rotation());
+
+				const Int32 translation_track_index = joint_index*kNumTrackTypes + kTranslationTrack;
+				const Track& translation_track = tracks_[translation_track_index];
+				if(translation_track.num_keys > 0)
+				{
+					const Int32 next_key = FindNextKey(translation_track, time, search_from_start ? -1 : cursor->next_keys_[translation_track_index]);
+					if(cursor)
+						cursor->next_keys_[translation_track_index] = next_key;
+
+					joint_pose.set_translation(SampleTranslation(translation_track, next_key, time));
+				}
+				else
+					joint_pose.set_translation(joint_bind_pose.translation());
+			}
+			else
+			{
+				joint_pose = joint_bind_pose;
+			}
+
+#ifdef REMOVE_BIND_POSE
+			joint_pose.Set(inv_joint_orients_[joint_index] * joint_pose.GetMatrix());
+#endif
+		}
+	}
+
+	ClipEvaluation::ClipEvaluation() :
+		pose(NULL),
+		clip(NULL),
+		cursor(NULL),
+		time(0.0f),
+		blend_clip(NULL),
+		blend_cursor(NULL),
+		blend_time(0.0f),
+		blend_weight(0.0f)
+	{
+	}
+
+	ClipBatch::ClipBatch(const Int32 num_threads) :
+		generation_(0),
+		num_running_(0),
+		quit_(false),
+		evaluations_(NULL),
+		num_evaluations_(0),
+		update_global_poses_(true),
+		next_evaluation_(0)
+	{
+		const Int32 total_threads = std::max(num_threads, 1);
+		blend_poses_.resize(total_threads);
+
+		// thread 0 is the thread calling Evaluate
+		for(Int32 thread_index = 1; thread_index < total_threads; ++thread_index)
+			workers_.push_back(std::thread(&ClipBatch::WorkerMain, this, thread_index));
+	}
+
+	ClipBatch::~ClipBatch()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			quit_ = true;
+		}
+		start_condition_.notify_all();
+
+		for(std::vector<std::thread>::iterator worker_iter = workers_.begin(); worker_iter != workers_.end(); ++worker_iter)
+			worker_iter->join();
+	}
+
+	void ClipBatch::Evaluate(ClipEvaluation* evaluations, const Int32 num_evaluations, const bool update_global_poses)
+	{
+		GEF_PROFILE_ZONE("ClipBatch::Evaluate");
+
+		if(num_evaluations <= 0)
+			return;
+
+		evaluations_ = evaluations;
+		num_evaluations_ = num_evaluations;
+		update_global_poses_ = update_global_poses;
+		next_evaluation_ = 0;
+
+		// not worth waking the workers for a single chunk
+		if(workers_.empty() || num_evaluations <= kClipBatchChunkSize)
+		{
+			EvaluateRange(0);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			num_running_ = (Int32)workers_.size();
+			++generation_;
+		}
+		start_condition_.notify_all();
+
+		EvaluateRange(0);
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		finish_condition_.wait(lock, [this] { return num_running_ == 0; });
+	}
+
+	void ClipBatch::EvaluateRange(const Int32 thread_index)
+	{
+		std::vector<JointPose>& blend_pose = blend_poses_[thread_index];
+
+		for(;;)
+		{
+			const Int32 first = next_evaluation_.fetch_add(kClipBatchChunkSize);
+			if(first >= num_evaluations_)
+				break;
+
+			const Int32 last = std::min(first + kClipBatchChunkSize, num_evaluations_);
+			for(Int32 evaluation_index = first; evaluation_index < last; ++evaluation_index)
+			{
+				const ClipEvaluation& evaluation = evaluations_[evaluation_index];
+				std::vector<JointPose>& local_pose = evaluation.pose->local_pose();
+
+				evaluation.clip->Evaluate(evaluation.time, evaluation.cursor, local_pose);
+
+				// blend towards the second clip the same way as SkeletonPose::Linear2PoseBlend
+				if(evaluation.blend_clip)
+				{
+					evaluation.blend_clip->Evaluate(evaluation.blend_time, evaluation.blend_cursor, blend_pose);
+
+					const size_t num_joints = std::min(local_pose.size(), blend_pose.size());
+					for(size_t joint_index = 0; joint_index < num_joints; ++joint_index)
+						local_pose[joint_index].Linear2TransformBlend(local_pose[joint_index], blend_pose[joint_index], evaluation.blend_weight);
+				}
+
+				if(update_global_poses_)
+					evaluation.pose->CalculateGlobalPose();
+			}
+		}
+	}
+
+	void ClipBatch::WorkerMain(const Int32 thread_index)
+	{
+		Profiler::SetThreadName("clip batch");
+
+		UInt32 generation = 0;
+		for(;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				start_condition_.wait(lock, [this, generation] { return quit_ || generation_ != generation; });
+				if(quit_)
+					return;
+
+				generation = generation_;
+			}
+
+			{
+				GEF_PROFILE_ZONE("ClipBatch::EvaluateRange");
+				EvaluateRange(thread_index);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				--num_running_;
+			}
+			finish_condition_.notify_one();
+		}
+	}
+}
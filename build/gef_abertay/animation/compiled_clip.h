@@ -0,0 +1,154 @@
+#ifndef _GEF_COMPILED_CLIP_H
+#define _GEF_COMPILED_CLIP_H
+
+#include <gef.h>
+#include <animation/joint.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace gef
+{
+	class Animation;
+	class Skeleton;
+	class SkeletonPose;
+	class CompiledClip;
+
+	// Playback state for one instance of a CompiledClip.
+	// Remembers the keys used at the last time evaluated, so playing forwards only steps over the keys passed
+	// since then instead of searching each track again. Going backwards, e.g. when a clip loops, searches again.
+	// A cursor can only be used on one thread at a time.
+	class ClipCursor
+	{
+	public:
+		ClipCursor();
+
+		// Start again from the beginning of the clip
+		void Reset();
+
+	private:
+		friend class CompiledClip;
+
+		std::vector<Int32> next_keys_;	// for each track, the first key after last_time_
+		float last_time_;
+		const CompiledClip* clip_;
+	};
+
+	// An Animation compiled for one skeleton. The tracks are stored in joint order with the keys in
+	// separate arrays for each component, so evaluating a pose doesn't look up the animation node for each joint.
+	// Evaluating gives the same local pose as SkeletonPose::SetPoseFromAnim.
+	class CompiledClip
+	{
+	public:
+		CompiledClip();
+
+		// The bind pose gives the skeleton and the local transforms used for joints with no keys
+		void Compile(const Animation& animation, const SkeletonPose& bind_pose);
+
+		// Set the local joint poses at a time. The cursor can be NULL.
+		void Evaluate(const float time, ClipCursor* cursor, std::vector<JointPose>& local_pose) const;
+
+		inline const Skeleton* skeleton() const { return skeleton_; }
+		inline Int32 joint_count() const { return (Int32)bind_pose_.size(); }
+		inline Int32 key_count() const { return (Int32)key_times_.size(); }
+		inline float duration() const { return duration_; }
+		inline float start_time() const { return start_time_; }
+		inline float end_time() const { return end_time_; }
+
+	private:
+		enum TrackType
+		{
+			kRotationTrack = 0,
+			kTranslationTrack,
+			kNumTrackTypes
+		};
+
+		struct Track
+		{
+			Int32 first_key;
+			Int32 num_keys;
+		};
+
+		void AddTrack(const Int32 num_keys);
+		Int32 FindNextKey(const Track& track, const float time, const Int32 start_key) const;
+		const Quaternion SampleRotation(const Track& track, const Int32 next_key, const float time) const;
+		const Vector4 SampleTranslation(const Track& track, const Int32 next_key, const float time) const;
+
+		const Skeleton* skeleton_;
+		std::vector<JointPose> bind_pose_;
+		std::vector<UInt8> animated_;		// for each joint, if the animation has a node for it
+		std::vector<Track> tracks_;			// kNumTrackTypes tracks for each joint
+
+		// the keys of every track
+		std::vector<float> key_times_;
+		std::vector<float> key_x_;
+		std::vector<float> key_y_;
+		std::vector<float> key_z_;
+		std::vector<float> key_w_;
+
+#ifdef REMOVE_BIND_POSE
+		std::vector<Matrix44> inv_joint_orients_;
+#endif
+
+		float duration_;
+		float start_time_;
+		float end_time_;
+	};
+
+	// One pose to set in a ClipBatch.
+	// If blend_clip is set the pose is blended from clip to blend_clip by blend_weight, as SkeletonPose::Linear2PoseBlend does.
+	struct ClipEvaluation
+	{
+		SkeletonPose* pose;				// created with SkeletonPose::CreateBindPose for the clip's skeleton
+		const CompiledClip* clip;
+		ClipCursor* cursor;				// can be NULL
+		float time;
+
+		const CompiledClip* blend_clip;	// can be NULL
+		ClipCursor* blend_cursor;		// can be NULL
+		float blend_time;
+		float blend_weight;
+
+		ClipEvaluation();
+	};
+
+	// Evaluates many poses at once, optionally split across threads.
+	// The calling thread always takes part, so one thread evaluates everything on the calling thread.
+	class ClipBatch
+	{
+	public:
+		ClipBatch(const Int32 num_threads = 1);
+		~ClipBatch();
+
+		// Set every pose, then calculate their global poses if update_global_poses is set.
+		// Each pose and cursor must only appear once in the batch.
+		void Evaluate(ClipEvaluation* evaluations, const Int32 num_evaluations, const bool update_global_poses = true);
+
+		inline Int32 num_threads() const { return (Int32)workers_.size() + 1; }
+
+	private:
+		void EvaluateRange(const Int32 thread_index);
+		void WorkerMain(const Int32 thread_index);
+
+		std::vector<std::thread> workers_;
+		std::mutex mutex_;
+		std::condition_variable start_condition_;
+		std::condition_variable finish_condition_;
+		UInt32 generation_;
+		Int32 num_running_;
+		bool quit_;
+
+		// the batch being evaluated
+		ClipEvaluation* evaluations_;
+		Int32 num_evaluations_;
+		bool update_global_poses_;
+		std::atomic<Int32> next_evaluation_;
+
+		// a pose for each thread to evaluate blend clips into
+		std::vector<std::vector<JointPose> > blend_poses_;
+	};
+}
+
+#endif // _GEF_COMPILED_CLIP_H
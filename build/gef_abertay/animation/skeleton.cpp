@@ -1,5 +1,6 @@
 #include <animation/skeleton.h>
 #include <animation/animation.h>
+#include <animation/compiled_clip.h>
 
 namespace gef
 {
@@ -191,6 +192,15 @@ namespace gef
 			CalculateGlobalPose();
 	}
 
+	void SkeletonPose::SetPoseFromClip(const CompiledClip& clip, ClipCursor* cursor, const float time, const bool updateGlobalPose)
+	{
+		// same pose as SetPoseFromAnim with the animation and bind pose the clip was compiled from
+		clip.Evaluate(time, cursor, local_pose_);
+
+		if(updateGlobalPose)
+			CalculateGlobalPose();
+	}
+
 	void SkeletonPose::Linear2PoseBlend(const SkeletonPose& start_pose, const SkeletonPose& end_pose, const float time)
 	{
 		// assume _startPose _endPose and "this" pose all have the same number of joints
@@ -316,12 +326,16 @@ namespace gef
 
 	bool Skeleton::Read(std::istream& stream)
 	{
-		Int32 num_joints;
+		Int32 num_joints = 0;
 		stream.read((char*)&num_joints, sizeof(Int32));
+		if(stream.fail() || num_joints < 0)
+			return false;
+
 		joints_.resize(num_joints);
-		stream.read((char*)&joints_.front(), sizeof(Joint)*num_joints);
+		if(num_joints > 0)
+			stream.read((char*)&joints_.front(), sizeof(Joint)*num_joints);
 
-		return true;
+		return !stream.fail();
 	}
 
 	bool Skeleton::Write(std::ostream& stream) const
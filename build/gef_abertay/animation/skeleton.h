@@ -47,6 +47,7 @@ namespace gef
 		void CalculateGlobalPose(const gef::Matrix44 * const pose_transform = NULL);
 		void CalculateLocalPose(const std::vector<Matrix44>& global_pose);
 		void SetPoseFromAnim(const class Animation& _anim, const SkeletonPose& _bindPose, const float _time, const bool _updateGlobalPose = true);
+		void SetPoseFromClip(const class CompiledClip& _clip, class ClipCursor* _cursor, const float _time, const bool _updateGlobalPose = true);
 	//	void SetLocalJointPoseFromAnim(JointPose& _jointPose, const UInt32 _jointNum, const JointPose& _jointBindPose, const class Anim& _anim, const float _time);
 		void Linear2PoseBlend(const SkeletonPose& _startPose, const SkeletonPose& _endPose, const float _time);
 
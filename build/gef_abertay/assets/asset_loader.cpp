@@ -0,0 +1,389 @@
+#include <assets/asset_loader.h>
+#include <assets/png_loader.h>
+#include <graphics/image_data.h>
+#include <graphics/texture.h>
+#include <graphics/font.h>
+#include <graphics/scene.h>
+#include <graphics/scene_cache.h>
+#include <audio/audio_manager.h>
+#include <system/profiler.h>
+#include <algorithm>
+
+namespace gef
+{
+	// milliseconds between two times
+	static float ElapsedMs(const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end)
+	{
+		return std::chrono::duration<float, std::milli>(end - start).count();
+	}
+
+	AssetRequest::AssetRequest(AssetType type, const char* filename) :
+		type_(type),
+		status_(ASSET_LOADING),
+		filename_(filename),
+		released_(false),
+		image_data_(NULL),
+		decoded_sample_(NULL),
+		decoded_(false),
+		texture_(NULL),
+		width_(0),
+		height_(0),
+		font_(NULL),
+		scene_(NULL),
+		scene_cache_(NULL),
+		audio_manager_(NULL),
+		sample_index_(-1),
+		request_time_(std::chrono::steady_clock::now())
+	{
+		decode_start_time_ = decode_end_time_ = request_time_;
+	}
+
+	AssetRequest::~AssetRequest()
+	{
+		delete image_data_;
+		delete decoded_sample_;
+	}
+
+	Mesh* AssetRequest::mesh() const
+	{
+		if(scene_ && !scene_->meshes.empty())
+			return scene_->meshes.front();
+
+		return NULL;
+	}
+
+	AssetLoader::AssetLoader(Platform& platform, Int32 num_workers) :
+		platform_(platform),
+		quit_(false),
+		num_loading_(0)
+	{
+		for(Int32 worker_num = 0; worker_num < num_workers; ++worker_num)
+			workers_.push_back(std::thread(&AssetLoader::WorkerMain, this));
+	}
+
+	AssetLoader::~AssetLoader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			quit_ = true;
+		}
+		queued_condition_.notify_all();
+
+		for(std::vector<std::thread>::iterator worker_iter = workers_.begin(); worker_iter != workers_.end(); ++worker_iter)
+			worker_iter->join();
+
+		// released requests that were still loading are only in the queues
+		queued_.insert(queued_.end(), decoded_.begin(), decoded_.end());
+		for(std::deque<AssetRequest*>::iterator request_iter = queued_.begin(); request_iter != queued_.end(); ++request_iter)
+		{
+			if((*request_iter)->released_)
+			{
+				Discard(*request_iter);
+				delete *request_iter;
+			}
+		}
+
+		// anything still loading is thrown away, finished results already belong to someone else
+		for(std::vector<AssetRequest*>::iterator request_iter = requests_.begin(); request_iter != requests_.end(); ++request_iter)
+		{
+			if(!(*request_iter)->finished())
+				Discard(*request_iter);
+			delete *request_iter;
+		}
+	}
+
+	AssetRequest* AssetLoader::LoadTexture(const char* filename)
+	{
+		return Queue(new AssetRequest(ASSET_TEXTURE, filename));
+	}
+
+	AssetRequest* AssetLoader::LoadFont(const char* font_name)
+	{
+		AssetRequest* request = new AssetRequest(ASSET_FONT, font_name);
+
+		// only the worker touches the font until it is finished
+		request->font_ = new Font(platform_);
+		return Queue(request);
+	}
+
+	AssetRequest* AssetLoader::LoadScene(SceneCache* scene_cache, const char* filename)
+	{
+		AssetRequest* request = new AssetRequest(ASSET_SCENE, filename);
+		request->scene_cache_ = scene_cache;
+
+		// scenes already in the cache are ready straight away
+		if(scene_cache->HasScene(filename))
+		{
+			request->scene_ = scene_cache->LoadScene(filename);
+			request->status_ = request->scene_ ? ASSET_READY : ASSET_FAILED;
+			requests_.push_back(request);
+			return request;
+		}
+
+		return Queue(request);
+	}
+
+	AssetRequest* AssetLoader::LoadSample(AudioManager* audio_manager, const char* filename)
+	{
+		AssetRequest* request = new AssetRequest(ASSET_SAMPLE, filename);
+		request->audio_manager_ = audio_manager;
+
+		// nothing to load the sample into
+		if(!audio_manager)
+		{
+			request->status_ = ASSET_FAILED;
+			requests_.push_back(request);
+			return request;
+		}
+
+		return Queue(request);
+	}
+
+	AssetRequest* AssetLoader::Queue(AssetRequest* request)
+	{
+		requests_.push_back(request);
+		num_loading_++;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			queued_.push_back(request);
+		}
+		queued_condition_.notify_one();
+
+		return request;
+	}
+
+	Int32 AssetLoader::Update()
+	{
+		GEF_PROFILE_ZONE("AssetLoader::Update");
+
+		// with no workers the decoding is done here
+		if(workers_.empty())
+		{
+			while(!queued_.empty())
+			{
+				AssetRequest* request = queued_.front();
+				queued_.pop_front();
+				Decode(request);
+				decoded_.push_back(request);
+			}
+		}
+
+		std::deque<AssetRequest*> decoded;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			decoded.swap(decoded_);
+		}
+
+		for(std::deque<AssetRequest*>::iterator request_iter = decoded.begin(); request_iter != decoded.end(); ++request_iter)
+		{
+			AssetRequest* request = *request_iter;
+			num_loading_--;
+
+			if(request->released_)
+			{
+				Discard(request);
+				delete request;
+			}
+			else
+			{
+				Finish(request);
+			}
+		}
+
+		return num_loading_;
+	}
+
+	void AssetLoader::FinishAll()
+	{
+		GEF_PROFILE_ZONE("AssetLoader::FinishAll");
+
+		while(Update() > 0)
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			decoded_condition_.wait(lock, [this] { return !decoded_.empty(); });
+		}
+	}
+
+	void AssetLoader::Release(AssetRequest* request)
+	{
+		if(!request)
+			return;
+
+		requests_.erase(std::remove(requests_.begin(), requests_.end(), request), requests_.end());
+
+		// requests still loading are deleted by Update once the worker is done with them
+		if(request->finished())
+			delete request;
+		else
+			request->released_ = true;
+	}
+
+	void AssetLoader::Decode(AssetRequest* request)
+	{
+		GEF_PROFILE_ZONE("AssetLoader::Decode");
+		request->decode_start_time_ = std::chrono::steady_clock::now();
+
+		switch(request->type_)
+		{
+		case ASSET_TEXTURE:
+			{
+				PNGLoader png_loader;
+				request->image_data_ = new ImageData();
+				png_loader.Load(request->filename_.c_str(), platform_, *request->image_data_);
+				request->decoded_ = request->image_data_->image() != NULL;
+			}
+			break;
+
+		case ASSET_FONT:
+			request->image_data_ = new ImageData();
+			request->decoded_ = request->font_->ReadFont(request->filename_.c_str(), *request->image_data_);
+			break;
+
+		case ASSET_SCENE:
+			request->scene_ = new Scene();
+			request->decoded_ = request->scene_->ReadSceneFromFile(platform_, request->filename_.c_str());
+			if(request->decoded_)
+			{
+				// decode the textures here too, so the main thread only has to create them
+				request->scene_->ReadTextureImages(platform_);
+			}
+			else
+			{
+				delete request->scene_;
+				request->scene_ = NULL;
+			}
+			break;
+
+		case ASSET_SAMPLE:
+			request->decoded_sample_ = request->audio_manager_->DecodeSample(request->filename_.c_str(), platform_);
+			request->decoded_ = request->decoded_sample_ != NULL;
+			break;
+
+		default:
+			break;
+		}
+
+		request->decode_end_time_ = std::chrono::steady_clock::now();
+	}
+
+	void AssetLoader::Finish(AssetRequest* request)
+	{
+		GEF_PROFILE_ZONE("AssetLoader::Finish");
+
+		bool success = request->decoded_;
+
+		switch(request->type_)
+		{
+		case ASSET_TEXTURE:
+			if(success)
+			{
+				request->texture_ = Texture::Create(platform_, *request->image_data_);
+				request->width_ = request->image_data_->width();
+				request->height_ = request->image_data_->height();
+				success = request->texture_ != NULL;
+			}
+			break;
+
+		case ASSET_FONT:
+			if(success)
+			{
+				request->font_->CreateTexture(*request->image_data_);
+			}
+			else
+			{
+				delete request->font_;
+				request->font_ = NULL;
+			}
+			break;
+
+		case ASSET_SCENE:
+			// failures are cached as well so the file isn't read again
+			request->scene_ = request->scene_cache_->AddScene(request->filename_.c_str(), request->scene_);
+			success = request->scene_ != NULL;
+			break;
+
+		case ASSET_SAMPLE:
+			request->sample_index_ = request->audio_manager_->AddSample(request->decoded_sample_, platform_);
+			request->decoded_sample_ = NULL;
+			success = request->sample_index_ >= 0;
+			break;
+
+		default:
+			break;
+		}
+
+		// the decoded data isn't needed any more
+		delete request->image_data_;
+		request->image_data_ = NULL;
+
+		request->status_ = success ? ASSET_READY : ASSET_FAILED;
+
+		const std::chrono::steady_clock::time_point finish_time = std::chrono::steady_clock::now();
+
+		AssetTiming timing;
+		timing.filename = request->filename_;
+		timing.type = request->type_;
+		timing.success = success;
+		timing.wait_ms = ElapsedMs(request->request_time_, request->decode_start_time_);
+		timing.decode_ms = ElapsedMs(request->decode_start_time_, request->decode_end_time_);
+		timing.finish_ms = ElapsedMs(request->decode_end_time_, finish_time);
+		timing.total_ms = ElapsedMs(request->request_time_, finish_time);
+		timings_.push_back(timing);
+	}
+
+	void AssetLoader::Discard(AssetRequest* request)
+	{
+		// throw away anything that was loaded but not handed over
+		delete request->font_;
+		request->font_ = NULL;
+		delete request->scene_;
+		request->scene_ = NULL;
+	}
+
+	void AssetLoader::WorkerMain()
+	{
+		Profiler::SetThreadName("asset loader");
+
+		for(;;)
+		{
+			AssetRequest* request = NULL;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				queued_condition_.wait(lock, [this] { return quit_ || !queued_.empty(); });
+				if(quit_)
+					return;
+
+				request = queued_.front();
+				queued_.pop_front();
+			}
+
+			Decode(request);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				decoded_.push_back(request);
+			}
+			decoded_condition_.notify_one();
+		}
+	}
+
+	const char* AssetLoader::AssetTypeName(AssetType type)
+	{
+		switch(type)
+		{
+		case ASSET_TEXTURE:	return "texture";
+		case ASSET_FONT:	return "font";
+		case ASSET_SCENE:	return "scene";
+		case ASSET_SAMPLE:	return "sample";
+		default:			return "unknown";
+		}
+	}
+
+	Int32 AssetLoader::DefaultWorkerCount()
+	{
+		// leave a core for the main thread, loading is mostly waiting on files and decoding a few of them
+		const Int32 num_cores = (Int32)std::thread::hardware_concurrency();
+		return std::max(1, std::min(num_cores - 1, 4));
+	}
+}
@@ -0,0 +1,163 @@
+#ifndef _GEF_ASSET_LOADER_H
+#define _GEF_ASSET_LOADER_H
+
+#include <gef.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+namespace gef
+{
+	class Platform;
+	class ImageData;
+	class Texture;
+	class Font;
+	class Scene;
+	class SceneCache;
+	class Mesh;
+	class AudioManager;
+	class DecodedSample;
+
+	enum AssetType
+	{
+		ASSET_TEXTURE = 0,
+		ASSET_FONT,
+		ASSET_SCENE,
+		ASSET_SAMPLE,
+		NUM_ASSET_TYPES
+	};
+
+	enum AssetStatus
+	{
+		ASSET_LOADING = 0,
+		ASSET_READY,
+		ASSET_FAILED
+	};
+
+	// How long one asset took to load, in milliseconds
+	struct AssetTiming
+	{
+		std::string filename;
+		AssetType type;
+		bool success;
+		float wait_ms;		// from the request until a worker started on it
+		float decode_ms;	// reading and decoding the file on the worker
+		float finish_ms;	// creating the texture, meshes or sound on the main thread
+		float total_ms;		// from the request until the asset was ready
+	};
+
+	// A request made to the AssetLoader. Its status only changes during AssetLoader::Update,
+	// so it can be polled once a frame. Requests are released with AssetLoader::Release.
+	class AssetRequest
+	{
+	public:
+		inline AssetType type() const { return type_; }
+		inline AssetStatus status() const { return status_; }
+		inline bool finished() const { return status_ != ASSET_LOADING; }
+		inline const std::string& filename() const { return filename_; }
+
+		// The results, valid once the status is ASSET_READY.
+		// Textures and fonts belong to the caller once they are ready, scenes belong to the scene cache
+		// and samples to the audio manager.
+		inline Texture* texture() const { return texture_; }
+		inline UInt32 width() const { return width_; }
+		inline UInt32 height() const { return height_; }
+		inline Font* font() const { return font_; }
+		inline Scene* scene() const { return scene_; }
+		Mesh* mesh() const;
+		inline Int32 sample_index() const { return sample_index_; }
+
+	private:
+		friend class AssetLoader;
+
+		AssetRequest(AssetType type, const char* filename);
+		~AssetRequest();
+
+		AssetType type_;
+		AssetStatus status_;
+		std::string filename_;
+		bool released_;
+
+		// decoded by a worker
+		ImageData* image_data_;
+		DecodedSample* decoded_sample_;
+		bool decoded_;
+
+		// results
+		Texture* texture_;
+		UInt32 width_;
+		UInt32 height_;
+		Font* font_;
+		Scene* scene_;
+		SceneCache* scene_cache_;
+		AudioManager* audio_manager_;
+		Int32 sample_index_;
+
+		std::chrono::steady_clock::time_point request_time_;
+		std::chrono::steady_clock::time_point decode_start_time_;
+		std::chrono::steady_clock::time_point decode_end_time_;
+	};
+
+	// Loads textures, fonts, scenes and audio samples in the background.
+	// Files are read and decoded on a pool of worker threads. Creating textures, meshes and sounds
+	// is left to Update, which must be called on the main thread, usually once a frame.
+	// With no worker threads everything is done during Update instead.
+	class AssetLoader
+	{
+	public:
+		AssetLoader(Platform& platform, Int32 num_workers = DefaultWorkerCount());
+		~AssetLoader();
+
+		AssetRequest* LoadTexture(const char* filename);
+		AssetRequest* LoadFont(const char* font_name);
+		AssetRequest* LoadScene(SceneCache* scene_cache, const char* filename);
+		AssetRequest* LoadSample(AudioManager* audio_manager, const char* filename);
+
+		// Finish any assets the workers have decoded. Returns the number of requests still loading.
+		Int32 Update();
+
+		// Wait until every request has finished
+		void FinishAll();
+
+		// Release a request. If it is still loading, it is cancelled and anything it loads is deleted.
+		void Release(AssetRequest* request);
+
+		inline Int32 num_loading() const { return num_loading_; }
+		inline Int32 num_workers() const { return (Int32)workers_.size(); }
+
+		// Timings of every asset finished since the last ClearTimings
+		inline const std::vector<AssetTiming>& timings() const { return timings_; }
+		inline void ClearTimings() { timings_.clear(); }
+
+		static const char* AssetTypeName(AssetType type);
+		static Int32 DefaultWorkerCount();
+
+	private:
+		AssetRequest* Queue(AssetRequest* request);
+		void Decode(AssetRequest* request);
+		void Finish(AssetRequest* request);
+		void Discard(AssetRequest* request);
+		void WorkerMain();
+
+		Platform& platform_;
+
+		std::vector<std::thread> workers_;
+		std::mutex mutex_;
+		std::condition_variable queued_condition_;
+		std::condition_variable decoded_condition_;
+		std::deque<AssetRequest*> queued_;
+		std::deque<AssetRequest*> decoded_;
+		bool quit_;
+
+		// only used on the main thread
+		std::vector<AssetRequest*> requests_;
+		Int32 num_loading_;
+		std::vector<AssetTiming> timings_;
+	};
+}
+
+#endif // _GEF_ASSET_LOADER_H
@@ -2,6 +2,7 @@
 #include <system/file.h>
 #include <system/platform.h>
 #include <graphics/image_data.h>
+#include <system/profiler.h>
 #include <stdio.h>
 #include <png.h>
 //#include <pngstruct.h>
@@ -46,6 +47,7 @@ namespace gef
 
     void PNGLoader::Load(const char* filename, const Platform& platform, ImageData& image_data)
     {
+        GEF_PROFILE_ZONE("PNGLoader::Load");
         File* png_file   = gef::File::Create();
 
         bool success = png_file->Open(filename);
@@ -74,6 +76,9 @@ namespace gef
                     int bitDepth = 0;
                     int colorType = -1;
 
+                    // libpng reads through this until the image has been parsed, so it must stay in scope until then
+                    PNGData data;
+
 
                     /* Create and initialize the png_struct
                      * with the desired error handler
@@ -135,7 +140,6 @@ namespace gef
 
                     if(success)
                     {
-						PNGData data;
 						data.p = buffer;
 						data.len = file_size;
 
@@ -231,6 +235,8 @@ namespace gef
                 buffer = NULL;
             }
         }
+
+        delete png_file;
     }
 
     void PNGLoader::ParseRGBA(UInt8* out_image_buffer, void* the_png_ptr,
@@ -10,4 +10,28 @@ namespace gef
 	AudioManager::~AudioManager()
 	{
 	}
+
+	DecodedSample* AudioManager::DecodeSample(const char *strFileName, const Platform& platform)
+	{
+		return new DecodedSample(strFileName);
+	}
+
+	Int32 AudioManager::AddSample(DecodedSample* sample, const Platform& platform)
+	{
+		Int32 sample_index = -1;
+		if (sample)
+			sample_index = LoadSample(sample->filename().c_str(), platform);
+
+		delete sample;
+		return sample_index;
+	}
+
+	DecodedSample::DecodedSample(const char* filename) :
+		filename_(filename)
+	{
+	}
+
+	DecodedSample::~DecodedSample()
+	{
+	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define _GEF_AUDIO_MANAGER_H
 
 #include <gef.h>
+#include <string>
 
 namespace gef
 {
@@ -20,6 +21,19 @@ namespace gef
 
 	class Platform;
 
+	// A sample decoded by AudioManager::DecodeSample, ready to be added with AudioManager::AddSample.
+	// Platforms that decode samples in DecodeSample derive from this to hold the decoded data.
+	class DecodedSample
+	{
+	public:
+		DecodedSample(const char* filename);
+		virtual ~DecodedSample();
+
+		inline const std::string& filename() const { return filename_; }
+	private:
+		std::string filename_;
+	};
+
 	class AudioManager
 	{
 	public:
@@ -47,6 +61,14 @@ namespace gef
 		virtual bool sample_voice_playing(const UInt32 voice_index) = 0;
 		virtual bool sample_voice_looping(const UInt32 voice_index) = 0;
 
+		// LoadSample split in two, so the slow part can be done on another thread.
+		// DecodeSample doesn't change the audio manager and can be called from any thread, it returns NULL on failure.
+		// AddSample must be called on the thread that uses the audio manager. It deletes the decoded sample
+		// and returns the sample index, or -1 on failure.
+		// By default all the work is done by LoadSample in AddSample.
+		virtual DecodedSample* DecodeSample(const char *strFileName, const Platform& platform);
+		virtual Int32 AddSample(DecodedSample* sample, const Platform& platform);
+
 
 		static AudioManager* Create();
 	protected:
@@ -0,0 +1,132 @@
+#include <graphics/default_3d_instanced_shader.h>
+#include <graphics/shader_interface.h>
+#include <graphics/mesh.h>
+#include <graphics/material.h>
+#include <graphics/colour.h>
+#include <graphics/default_3d_shader_data.h>
+
+namespace gef
+{
+	Default3DInstancedShader::Default3DInstancedShader(const Platform& platform)
+	:Shader(platform)
+	,view_projection_matrix_variable_index_(-1)
+	,light_position_variable_index_(-1)
+	,material_colour_variable_index_(-1)
+	,ambient_light_colour_variable_index_(-1)
+	,light_colour_variable_index_(-1)
+	,texture_sampler_index_(-1)
+	{
+		// the pixel shader is shared with the default 3D shader
+		char* vs_shader_source = NULL;
+		Int32 vs_shader_source_length = 0;
+		LoadShader("default_3d_instanced_shader_vs", "shaders/gef", &vs_shader_source, vs_shader_source_length, platform);
+
+		char* ps_shader_source = NULL;
+		Int32 ps_shader_source_length = 0;
+		LoadShader("default_3d_shader_ps", "shaders/gef", &ps_shader_source, ps_shader_source_length, platform);
+
+		device_interface_->SetVertexShaderSource(vs_shader_source, vs_shader_source_length);
+		device_interface_->SetPixelShaderSource(ps_shader_source, ps_shader_source_length);
+
+		delete[] vs_shader_source;
+		vs_shader_source = NULL;
+		delete[] ps_shader_source;
+		ps_shader_source = NULL;
+
+		view_projection_matrix_variable_index_ = device_interface_->AddVertexShaderVariable("view_projection", ShaderInterface::kMatrix44);
+		light_position_variable_index_ = device_interface_->AddVertexShaderVariable("light_position", ShaderInterface::kVector4, 4);
+
+		// pixel shader variables, must match the layout of the default 3D pixel shader
+		material_colour_variable_index_ = device_interface_->AddPixelShaderVariable("material_colour", ShaderInterface::kVector4);
+		ambient_light_colour_variable_index_ = device_interface_->AddPixelShaderVariable("ambient_light_colour", ShaderInterface::kVector4);
+		light_colour_variable_index_ = device_interface_->AddPixelShaderVariable("light_colour", ShaderInterface::kVector4, 4);
+
+		texture_sampler_index_ = device_interface_->AddTextureSampler("texture_sampler");
+
+		device_interface_->AddVertexParameter("position", ShaderInterface::kVector3, 0, "POSITION", 0);
+		device_interface_->AddVertexParameter("normal", ShaderInterface::kVector3, 12, "NORMAL", 0);
+		device_interface_->AddVertexParameter("uv", ShaderInterface::kVector2, 24, "TEXCOORD", 0);
+		device_interface_->set_vertex_size(sizeof(Mesh::Vertex));
+
+		// one world matrix per instance, a row per parameter
+		device_interface_->AddInstanceParameter("world0", ShaderInterface::kVector4, 0, "WORLD", 0);
+		device_interface_->AddInstanceParameter("world1", ShaderInterface::kVector4, 16, "WORLD", 1);
+		device_interface_->AddInstanceParameter("world2", ShaderInterface::kVector4, 32, "WORLD", 2);
+		device_interface_->AddInstanceParameter("world3", ShaderInterface::kVector4, 48, "WORLD", 3);
+		device_interface_->CreateVertexFormat();
+
+		device_interface_->AddSamplerState(ShaderInterface::kWrap);
+
+		device_interface_->CreateProgram();
+	}
+
+	Default3DInstancedShader::Default3DInstancedShader()
+		: view_projection_matrix_variable_index_(-1)
+		, light_position_variable_index_(-1)
+		, material_colour_variable_index_(-1)
+		, ambient_light_colour_variable_index_(-1)
+		, light_colour_variable_index_(-1)
+		, texture_sampler_index_(-1)
+	{
+	}
+
+	Default3DInstancedShader::~Default3DInstancedShader()
+	{
+	}
+
+	void Default3DInstancedShader::SetSceneData(const Default3DShaderData& shader_data, const Matrix44& view_matrix, const Matrix44& projection_matrix)
+	{
+		gef::Vector4 light_positions[MAX_NUM_POINT_LIGHTS];
+		gef::Vector4 light_colours[MAX_NUM_POINT_LIGHTS];
+		gef::Vector4 ambient_light_colour = shader_data.ambient_light_colour().GetRGBAasVector4();
+
+		for (Int32 light_num = 0; light_num < MAX_NUM_POINT_LIGHTS; ++light_num)
+		{
+			Vector4 light_position;
+			Colour light_colour;
+			if (light_num < shader_data.GetNumPointLights())
+			{
+				const PointLight& point_light = shader_data.GetPointLight(light_num);
+				light_position = point_light.position();
+				light_colour = point_light.colour();
+			}
+			else
+			{
+				// no light data
+				// set this light to a light with no colour
+				light_position = Vector4(0.0f, 0.0f, 0.0f);
+				light_colour = Colour(0.0f, 0.0f, 0.0f);
+			}
+			light_positions[light_num] = Vector4(light_position.x(), light_position.y(), light_position.z(), 1.f);
+			light_colours[light_num] = light_colour.GetRGBAasVector4();
+		}
+
+		// the world matrix is applied per instance in the vertex shader, so only view projection goes in the constant buffer
+		gef::Matrix44 view_projection = view_matrix * projection_matrix;
+		gef::Matrix44 view_projectionT;
+		view_projectionT.Transpose(view_projection);
+
+		device_interface_->SetVertexShaderVariable(view_projection_matrix_variable_index_, &view_projectionT);
+		device_interface_->SetVertexShaderVariable(light_position_variable_index_, (float*)light_positions);
+		device_interface_->SetPixelShaderVariable(ambient_light_colour_variable_index_, (float*)&ambient_light_colour);
+		device_interface_->SetPixelShaderVariable(light_colour_variable_index_, (float*)light_colours);
+	}
+
+	void Default3DInstancedShader::SetMaterialData(const gef::Material* material)
+	{
+		Colour material_colour(1.0f, 1.0f, 1.0f, 1.0f);
+		if (material)
+		{
+			primitive_data_.material_texture = material->texture();
+			material_colour.SetFromAGBR(material->colour());
+		}
+		else
+			primitive_data_.material_texture = NULL;
+
+		primitive_data_.material_colour = material_colour.GetRGBAasVector4();
+
+		device_interface_->SetPixelShaderVariable(material_colour_variable_index_, (float*)&primitive_data_.material_colour);
+		device_interface_->SetTextureSampler(texture_sampler_index_, primitive_data_.material_texture);
+	}
+
+} /* namespace gef */
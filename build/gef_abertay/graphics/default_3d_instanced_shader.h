@@ -0,0 +1,46 @@
+#ifndef GRAPHICS_DEFAULT_3D_INSTANCED_SHADER_H_
+#define GRAPHICS_DEFAULT_3D_INSTANCED_SHADER_H_
+
+#include <graphics/shader.h>
+#include <gef.h>
+#include <maths/vector4.h>
+#include <maths/matrix44.h>
+#include <graphics/default_3d_shader.h>
+
+namespace gef
+{
+	class Material;
+	class Texture;
+	class Default3DShaderData;
+
+	/**
+	Version of the default 3D shader which draws many copies of a mesh in one draw call.
+	The world matrix of each copy is read from a per instance vertex buffer instead of the constant buffer.
+	*/
+	class Default3DInstancedShader : public Shader
+	{
+	public:
+		Default3DInstancedShader(const Platform& platform);
+		virtual ~Default3DInstancedShader();
+
+		void SetSceneData(const Default3DShaderData& shader_data, const Matrix44& view_matrix, const Matrix44& projection_matrix);
+		void SetMaterialData(const gef::Material* material);
+
+	protected:
+		Default3DInstancedShader();
+
+		Int32 view_projection_matrix_variable_index_;
+		Int32 light_position_variable_index_;
+
+		Int32 material_colour_variable_index_;
+		Int32 ambient_light_colour_variable_index_;
+		Int32 light_colour_variable_index_;
+
+		Int32 texture_sampler_index_;
+
+		Default3DShader::PrimitiveData primitive_data_;
+	};
+
+} /* namespace gef */
+
+#endif /* GRAPHICS_DEFAULT_3D_INSTANCED_SHADER_H_ */
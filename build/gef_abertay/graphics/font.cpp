@@ -8,6 +8,7 @@
 #include <system/platform.h>
 #include <system/file.h>
 #include <system/memory_stream_buffer.h>
+#include <system/profiler.h>
 //#include <fstream>
 #include <sstream>
 #include <cstdarg>
@@ -38,6 +39,16 @@ Font::~Font()
 }
 
 bool Font::Load(const char* font_name)
+{
+	gef::ImageData image_data;
+	bool config_initialised = ReadFont(font_name, image_data);
+	if(config_initialised)
+		CreateTexture(image_data);
+
+	return config_initialised;
+}
+
+bool Font::ReadFont(const char* font_name, ImageData& texture_image)
 {
 	std::string font_config_filename(font_name);
 	font_config_filename += ".fnt";
@@ -63,9 +74,9 @@ bool Font::Load(const char* font_name)
 			}
 		}
 		file->Close();
-		delete file;
-		file = NULL;
 	}
+	delete file;
+	file = NULL;
 
 
 
@@ -78,22 +89,31 @@ bool Font::Load(const char* font_name)
 		std::istream font_config_stream(&font_buffer);
 		config_initialised = ParseFont(font_config_stream, character_set);
 
-		// don't need the font file data any more
-		free(font_file_data);
-		font_file_data = NULL;
-
 		std::string font_texture_filename(font_name);
 		font_texture_filename += "_0.png";
 		PNGLoader png_loader;
-		gef::ImageData image_data;
-		png_loader.Load(font_texture_filename.c_str(), platform_, image_data);
-		font_texture_ = gef::Texture::Create(platform_, image_data);
-		platform_.AddTexture(font_texture_);
+		png_loader.Load(font_texture_filename.c_str(), platform_, texture_image);
 	}
 
+	// don't need the font file data any more
+	free(font_file_data);
+	font_file_data = NULL;
+
 	return config_initialised;
 }
 
+void Font::CreateTexture(const ImageData& texture_image)
+{
+	if(font_texture_)
+	{
+		platform_.RemoveTexture(font_texture_);
+		delete font_texture_;
+	}
+
+	font_texture_ = gef::Texture::Create(platform_, texture_image);
+	platform_.AddTexture(font_texture_);
+}
+
 
 bool Font::ParseFont( std::istream& Stream, Font::Charset& CharsetDesc )
 {
@@ -175,6 +195,8 @@ bool Font::ParseFont( std::istream& Stream, Font::Charset& CharsetDesc )
 
 void Font::RenderText(SpriteRenderer* renderer, const class Vector4& pos, const float scale, const UInt32 colour, const TextJustification justification, const char* text, ...) const
 {
+	GEF_PROFILE_ZONE("Font::RenderText");
+
 	if(!text)
 		return;
 
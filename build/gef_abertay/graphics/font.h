@@ -11,6 +11,7 @@ namespace gef
 	class Texture;
 	class Platform;
 	class Vector4;
+	class ImageData;
 
 	enum TextJustification
 	{
@@ -25,6 +26,12 @@ namespace gef
 		Font(Platform& platform);
 		~Font();
 		bool Load(const char* font_name);
+
+		// Load split in two. ReadFont reads the font description and decodes the texture image,
+		// and only changes this font so it can be called from any thread.
+		// CreateTexture must be called on the rendering thread afterwards, and only if ReadFont succeeded.
+		bool ReadFont(const char* font_name, ImageData& texture_image);
+		void CreateTexture(const ImageData& texture_image);
 		void RenderText(SpriteRenderer* renderer, const Vector4& pos, const float scale, const UInt32 colour, const TextJustification justification, const char * text, ...) const;
 		float GetStringLength(const char * text) const;
 
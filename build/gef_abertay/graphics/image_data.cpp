@@ -5,13 +5,15 @@ namespace gef
 {
 	ImageData::ImageData() :
 		image_(NULL),
-		clut_(NULL)
+		clut_(NULL),
+		width_(0),
+		height_(0)
 	{
 	}
 
 	ImageData::~ImageData()
 	{
-		delete image_;
-		delete clut_;
+		free(image_);
+		free(clut_);
 	}
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ namespace gef
 		ImageData();
 		~ImageData();
 
+		// the image and clut are allocated with malloc, and are freed with the ImageData
 		UInt8* image() const { return image_; }
 		void set_image(UInt8* const image) { image_ = image; }
 		const UInt8* clut() const { return clut_; }
@@ -64,17 +64,16 @@ namespace gef
 
 
 	VertexData::VertexData() :
-		vertices(NULL)
+		vertices(NULL),
+		owns_vertices(true)
 	{
 	}
 
 	VertexData::~VertexData()
 	{
-		if (vertices)
-		{
+		if (vertices && owns_vertices)
 			free(vertices);
-			vertices = NULL;
-		}
+		vertices = NULL;
 	}
 
 	bool VertexData::Read(std::istream& stream)
@@ -85,6 +84,7 @@ namespace gef
 		stream.read((char*)&vertex_byte_size, sizeof(Int32));
 
 		vertices = malloc(num_vertices*vertex_byte_size);
+		owns_vertices = true;
 		if(vertices)
 			stream.read((char*)vertices, num_vertices*vertex_byte_size);
 		else
@@ -107,13 +107,15 @@ namespace gef
 
 	PrimitiveData::PrimitiveData() :
 		indices(NULL),
-		material_name_id(0)
+		material_name_id(0),
+		owns_indices(true)
 	{
 	}
 
 	PrimitiveData::~PrimitiveData()
 	{
-		free(indices);
+		if (owns_indices)
+			free(indices);
 		indices = NULL;
 	}
 
@@ -129,6 +131,7 @@ namespace gef
 		stream.read((char*)&type, sizeof(PrimitiveType));
 
 		indices = malloc(num_indices*index_byte_size);
+		owns_indices = true;
 		if(indices)
 			stream.read((char*)indices, num_indices*index_byte_size);
 		else
@@ -37,6 +37,9 @@ namespace gef
 		Int32 num_indices;
 		Int32 index_byte_size;
 		PrimitiveType type;
+
+		// false when indices point into memory owned by something else, e.g. a mapped scene file
+		bool owns_indices;
 	};
 
 	struct VertexData
@@ -50,6 +53,9 @@ namespace gef
 		void* vertices;
 		Int32 num_vertices;
 		Int32 vertex_byte_size;
+
+		// false when vertices point into memory owned by something else, e.g. a mapped scene file
+		bool owns_vertices;
 	};
 
 
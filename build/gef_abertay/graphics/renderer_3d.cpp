@@ -2,6 +2,8 @@
 #include <graphics/shader.h>
 #include <system/platform.h>
 #include <graphics/texture.h>
+#include <algorithm>
+#include <functional>
 
 namespace gef
 {
@@ -19,6 +21,10 @@ namespace gef
 		projection_matrix_.SetIdentity();
 		view_matrix_.SetIdentity();
 		world_matrix_.SetIdentity();
+
+		stats_.draw_calls = 0;
+		stats_.state_changes = 0;
+		stats_.instances = 0;
 	}
 
 	Renderer3D::~Renderer3D()
@@ -69,6 +75,84 @@ namespace gef
 		inv_world_transpose_matrix_.Transpose(inv_world);
 	}
 
+	void Renderer3D::SubmitMesh(const Mesh& mesh, const gef::Matrix44& matrix, const Material* material)
+	{
+		MeshSubmission submission;
+		submission.mesh = &mesh;
+		submission.material = material;
+		submission.matrix_index = (Int32)submitted_matrices_.size();
+		submissions_.push_back(submission);
+		submitted_matrices_.push_back(matrix);
+	}
+
+	bool Renderer3D::SubmissionOrder(const MeshSubmission& a, const MeshSubmission& b)
+	{
+		// std::less gives a total order over unrelated pointers, where < does not
+		std::less<const void*> pointer_less;
+		if (a.mesh != b.mesh)
+			return pointer_less(a.mesh, b.mesh);
+		if (a.material != b.material)
+			return pointer_less(a.material, b.material);
+
+		// keep submission order within a group
+		return a.matrix_index < b.matrix_index;
+	}
+
+	void Renderer3D::FlushSubmittedMeshes()
+	{
+		if (submissions_.empty())
+			return;
+
+		// sort the small submission records rather than the matrices
+		std::sort(submissions_.begin(), submissions_.end(), SubmissionOrder);
+
+		// gather the matrices into sorted order so each group is contiguous
+		sorted_matrices_.resize(submissions_.size());
+		for (size_t submission_num = 0; submission_num < submissions_.size(); ++submission_num)
+			sorted_matrices_[submission_num] = submitted_matrices_[submissions_[submission_num].matrix_index];
+
+		// one call per run of the same mesh and material, split so no call is given more than kMaxInstancesPerDraw instances
+		size_t group_start = 0;
+		for (size_t submission_num = 1; submission_num <= submissions_.size(); ++submission_num)
+		{
+			if (submission_num == submissions_.size()
+				|| submission_num - group_start == (size_t)kMaxInstancesPerDraw
+				|| submissions_[submission_num].mesh != submissions_[group_start].mesh
+				|| submissions_[submission_num].material != submissions_[group_start].material)
+			{
+				const MeshSubmission& group = submissions_[group_start];
+				DrawMeshInstances(*group.mesh, group.material, &sorted_matrices_[group_start], (Int32)(submission_num - group_start));
+				group_start = submission_num;
+			}
+		}
+
+		// the vectors keep their capacity so later frames don't allocate
+		submissions_.clear();
+		submitted_matrices_.clear();
+	}
+
+	void Renderer3D::DrawMeshInstances(const Mesh& mesh, const Material* material, const gef::Matrix44* matrices, Int32 num_instances)
+	{
+		// draw the instances one at a time, using the instance material in place of any override material
+		const Material* previous_override_material = override_material_;
+		override_material_ = material;
+
+		for (Int32 instance_num = 0; instance_num < num_instances; ++instance_num)
+			DrawMesh(mesh, matrices[instance_num]);
+
+		override_material_ = previous_override_material;
+	}
+
+	void Renderer3D::ResetFrame()
+	{
+		stats_.draw_calls = 0;
+		stats_.state_changes = 0;
+		stats_.instances = 0;
+
+		submissions_.clear();
+		submitted_matrices_.clear();
+	}
+
 	void Renderer3D::set_world_matrix(const  Matrix44& matrix)
 	{
 		world_matrix_ = matrix;
@@ -21,6 +21,18 @@ namespace gef
 
 	class Skeleton;
 
+	/**
+	Counters for the work a Renderer3D has sent to the graphics device since the last Begin.
+	*/
+	struct Renderer3DStats
+	{
+		/// number of draw calls issued
+		Int32 draw_calls;
+		/// number of vertex buffer and material changes
+		Int32 state_changes;
+		/// number of mesh instances drawn
+		Int32 instances;
+	};
 
 	class Renderer3D
 	{
@@ -53,6 +65,17 @@ namespace gef
 		virtual void SetPrimitiveType(gef::PrimitiveType type) = 0;
 		virtual void DrawPrimitive(const IndexBuffer* index_buffer, int num_indices) = 0;
 
+		/// @brief Queue a mesh to be drawn when End is called.
+		/// @note Queued meshes are sorted by mesh and material, and each group is drawn with instanced draws of at most kMaxInstancesPerDraw instances where the platform supports it.
+		/// @param[in] mesh		The mesh to draw.
+		/// @param[in] matrix	The world matrix of this instance.
+		/// @param[in] material	Material used for every primitive of the mesh, NULL to use the primitives' own materials.
+		void SubmitMesh(const Mesh& mesh, const gef::Matrix44& matrix, const Material* material = NULL);
+
+		/// @brief Draw all meshes queued by SubmitMesh. Called by End, but can be called earlier to draw the queue before other meshes.
+		void FlushSubmittedMeshes();
+
+		inline const Renderer3DStats& stats() const { return stats_; }
 
 
 		inline  Shader* shader() const { return shader_; }
@@ -78,11 +101,34 @@ namespace gef
 		inline void set_clear_stencil_buffer_enabled(bool val) { clear_stencil_buffer_enabled_ = val; }
 		inline float fov() const { return fov_; }
 		inline void set_fov(float val) { fov_ = val; }
+		/// maximum number of instances passed to one DrawMeshInstances call, larger groups are split
+		static const Int32 kMaxInstancesPerDraw = 1024;
+
 	protected:
 		Renderer3D(Platform& platform);
 		void CalculateInverseWorldTransposeMatrix();
 		inline void set_shader( Shader* shader) { shader_ = shader; }
 
+		/// @brief Draw several instances of a mesh which share a material.
+		/// @note The default implementation draws each instance with DrawMesh, platforms with instancing support override this.
+		/// @param[in] mesh				The mesh to draw.
+		/// @param[in] material			Material used for every primitive of the mesh, NULL to use the primitives' own materials.
+		/// @param[in] matrices			World matrix of each instance.
+		/// @param[in] num_instances	Number of instances, no more than kMaxInstancesPerDraw.
+		virtual void DrawMeshInstances(const Mesh& mesh, const Material* material, const gef::Matrix44* matrices, Int32 num_instances);
+
+		/// @brief Reset the stats and discard any queued meshes, called at the start of each Begin.
+		void ResetFrame();
+
+		// a mesh queued by SubmitMesh, sorted so instances of the same mesh and material are next to each other
+		struct MeshSubmission
+		{
+			const Mesh* mesh;
+			const Material* material;
+			Int32 matrix_index;
+		};
+		static bool SubmissionOrder(const MeshSubmission& a, const MeshSubmission& b);
+
 		Matrix44 projection_matrix_;
 		Matrix44 view_matrix_;
 		Matrix44 inv_world_transpose_matrix_;
@@ -101,6 +147,11 @@ namespace gef
 		bool clear_stencil_buffer_enabled_;
 
 		float fov_;
+
+		Renderer3DStats stats_;
+		std::vector<MeshSubmission> submissions_;
+		std::vector<Matrix44> submitted_matrices_;
+		std::vector<Matrix44> sorted_matrices_;
 	};
 }
 #endif // _GEF_RENDERER_3D_H
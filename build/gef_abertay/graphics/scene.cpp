@@ -10,12 +10,108 @@
 #include <graphics/material.h>
 
 #include <system/file.h>
+#include <system/profiler.h>
+#include <system/mapped_file.h>
 #include <system/memory_stream_buffer.h>
 #include <fstream>
+#include <sstream>
+#include <cstring>
 #include <assert.h>
 
 namespace gef
 {
+	// Mapped scene files are laid out so they can be used in place once loaded. Everything is found
+	// through offsets from the start of the file, so the file can be mapped at any address.
+	// Vertex and index data are aligned so they can be given straight to the graphics API.
+	// Skeletons and animations are stored in the stream format, as they are copied when read anyway.
+	// Values are stored in the byte order of the platform, like the stream format.
+	static const UInt32 kMappedSceneMagic = 0x4e435347; // "GSCN"
+	static const UInt32 kMappedSceneVersion = 1;
+	static const UInt32 kMappedSceneDataAlignment = 16;
+
+	struct MappedSceneHeader
+	{
+		UInt32 magic;
+		UInt32 version;
+		UInt32 file_size;
+		Int32 string_count;
+		UInt32 strings_offset;
+		Int32 material_count;
+		UInt32 materials_offset;
+		Int32 mesh_count;
+		UInt32 meshes_offset;
+		Int32 skeleton_count;
+		Int32 animation_count;
+		UInt32 stream_offset;
+		UInt32 stream_size;
+	};
+
+	struct MappedMaterialRecord
+	{
+		StringId name_id;
+		UInt32 colour;
+		UInt32 diffuse_texture_offset; // 0 if there is no texture
+	};
+
+	struct MappedMeshRecord
+	{
+		StringId name_id;
+		float aabb_min[3];
+		float aabb_max[3];
+		Int32 num_vertices;
+		Int32 vertex_byte_size;
+		UInt32 vertices_offset;
+		Int32 num_primitives;
+		UInt32 primitives_offset;
+	};
+
+	struct MappedPrimitiveRecord
+	{
+		StringId material_name_id;
+		Int32 type;
+		Int32 num_indices;
+		Int32 index_byte_size;
+		UInt32 indices_offset;
+	};
+
+	// Add data to the end of a mapped scene being built and return its offset.
+	// If data is NULL the space is left as zeros to be filled in later.
+	static UInt32 AppendMappedData(std::vector<char>& buffer, const void* data, size_t size, UInt32 alignment)
+	{
+		size_t offset = (buffer.size() + alignment - 1) & ~(size_t)(alignment - 1);
+		buffer.resize(offset + size, 0);
+		if(data && size > 0)
+			memcpy(&buffer[offset], data, size);
+		return (UInt32)offset;
+	}
+
+	// Check that count items of item_size bytes at offset are inside the file
+	static bool InMappedScene(UInt32 offset, Int32 count, UInt32 item_size, UInt32 file_size)
+	{
+		if(count < 0 || offset > file_size)
+			return false;
+
+		return item_size == 0 || (UInt32)count <= (file_size - offset) / item_size;
+	}
+
+	// Read a null terminated string from the file, failing if it runs off the end
+	static bool ReadMappedString(const char* file, UInt32 offset, UInt32 file_size, std::string& result)
+	{
+		if(offset >= file_size)
+			return false;
+
+		const char* end = (const char*)memchr(file + offset, 0, file_size - offset);
+		if(!end)
+			return false;
+
+		result.assign(file + offset, end);
+		return true;
+	}
+
+	Scene::Scene()
+	{
+	}
+
 	Scene::~Scene()
 	{
 		// free up skeletons
@@ -26,9 +122,11 @@ namespace gef
 //		for(std::list<MeshData>::iterator mesh_iter = mesh_data.begin(); mesh_iter != mesh_data.end(); ++mesh_iter)
 //			delete *mesh_iter;
 
-		// free up textures
+		// free up textures, and any images decoded for them which were never used
 		for(std::list<Texture*>::iterator texture_iter = textures.begin(); texture_iter != textures.end(); ++texture_iter)
 			delete *texture_iter;
+		for(std::map<gef::StringId, ImageData*>::iterator image_iter = texture_images.begin(); image_iter != texture_images.end(); ++image_iter)
+			delete image_iter->second;
 
 		// free up materials
 		for(std::list<Material*>::iterator material_iter = materials.begin(); material_iter != materials.end(); ++material_iter)
@@ -42,6 +140,10 @@ namespace gef
 		// free up animations
 		for(std::map<gef::StringId, Animation*>::iterator animation_iter = animations.begin(); animation_iter != animations.end(); ++animation_iter)
 			delete animation_iter->second;
+
+		// mesh_data may point into the mapped files, but it doesn't free memory it doesn't own
+		for(std::vector<MappedFile*>::iterator file_iter = mapped_files_.begin(); file_iter != mapped_files_.end(); ++file_iter)
+			delete *file_iter;
 	}
 
 	Mesh* Scene::CreateMesh(Platform& platform, const MeshData& mesh_data, const bool read_only)
@@ -115,12 +217,24 @@ namespace gef
 				{
 					string_id_table.Add(materialIter->diffuse_texture);
 
-					ImageData image_data;
-					PNGLoader png_loader;
-					png_loader.Load(materialIter->diffuse_texture.c_str(), platform, image_data);
-					if(image_data.image() != NULL)
+					// use the image decoded by ReadTextureImages, only reading the file here if it wasn't
+					const ImageData* image_data = NULL;
+					ImageData loaded_image_data;
+					std::map<gef::StringId, ImageData*>::const_iterator image_iter = texture_images.find(texture_name_id);
+					if(image_iter != texture_images.end())
+					{
+						image_data = image_iter->second;
+					}
+					else
+					{
+						PNGLoader png_loader;
+						png_loader.Load(materialIter->diffuse_texture.c_str(), platform, loaded_image_data);
+						image_data = &loaded_image_data;
+					}
+
+					if(image_data && image_data->image() != NULL)
 					{
-						Texture* texture = Texture::Create(platform, image_data);
+						Texture* texture = Texture::Create(platform, *image_data);
 						textures.push_back(texture);
 						textures_map[texture_name_id] = texture;
 						material->set_texture(texture);
@@ -132,6 +246,38 @@ namespace gef
 				}
 			}
 		}
+
+		// the textures have been created, the images aren't needed any more
+		for(std::map<gef::StringId, ImageData*>::iterator image_iter = texture_images.begin(); image_iter != texture_images.end(); ++image_iter)
+			delete image_iter->second;
+		texture_images.clear();
+	}
+
+	void Scene::ReadTextureImages(const Platform& platform)
+	{
+		GEF_PROFILE_ZONE("Scene::ReadTextureImages");
+		for(std::list<MaterialData>::const_iterator material_iter = material_data.begin(); material_iter != material_data.end(); ++material_iter)
+		{
+			if(material_iter->diffuse_texture == "")
+				continue;
+
+			// materials can share a texture
+			gef::StringId texture_name_id = gef::GetStringId(material_iter->diffuse_texture);
+			if(texture_images.find(texture_name_id) != texture_images.end())
+				continue;
+
+			// a failed read is kept as NULL, so CreateMaterials doesn't try the file again
+			ImageData* image_data = new ImageData();
+			PNGLoader png_loader;
+			png_loader.Load(material_iter->diffuse_texture.c_str(), platform, *image_data);
+			if(image_data->image() == NULL)
+			{
+				delete image_data;
+				image_data = NULL;
+			}
+
+			texture_images[texture_name_id] = image_data;
+		}
 	}
 
 
@@ -154,45 +300,56 @@ namespace gef
 		return success;
 	}
 
+	bool Scene::WriteMappedSceneToFile(const Platform& platform, const char* filename) const
+	{
+		bool success = true;
+
+		std::ofstream file_stream(filename, std::ios::out | std::ios::binary);
+		if(file_stream.is_open())
+		{
+			success = WriteMappedScene(file_stream);
+		}
+		else
+		{
+			success = false;
+		}
+
+		file_stream.close();
+
+		return success;
+	}
+
 	bool Scene::ReadSceneFromFile(const Platform& platform, const char* filename)
 	{
+		GEF_PROFILE_ZONE("Scene::ReadSceneFromFile");
 		bool success = true;
-		void* file_data = NULL;
-		File* file = gef::File::Create();
-		Int32 file_size;
+		MappedFile* file = MappedFile::Create();
 
 		success = file->Open(filename);
 		if(success)
 		{
-			success = file->GetSize(file_size);
-			if(success)
+			if(IsMappedScene(file->data(), file->size()))
 			{
-				file_data = malloc(file_size);
-				success = file_data != NULL;
-				if(success)
-				{
-					Int32 bytes_read;
-					success = file->Read(file_data, file_size, bytes_read);
-					if(success)
-						success = bytes_read == file_size;
-				}
+				success = ReadMappedScene(file->data(), file->size());
 
+				// mesh_data points into the file, so keep it open while the scene exists
 				if(success)
 				{
-					gef::MemoryStreamBuffer stream_buffer((char*)file_data, file_size);
-
-					std::istream input_stream(&stream_buffer);
-					success = ReadScene(input_stream);
-
-					// don't need the font file data any more
-					free(file_data);
-					file_data = NULL;
+					mapped_files_.push_back(file);
+					file = NULL;
 				}
-
 			}
+			else
+			{
+				// older scene files are read through the stream reader, straight from the mapped file
+				gef::MemoryStreamBuffer stream_buffer((char*)file->data(), file->size());
 
-			file->Close();
+				std::istream input_stream(&stream_buffer);
+				success = ReadScene(input_stream);
+			}
 		}
+
+		delete file;
 		return success;
 	}
 
@@ -261,22 +418,7 @@ namespace gef
 			//}
 		}
 
-		// skeletons
-		for(Int32 skeleton_num=0;skeleton_num<skeleton_count;++skeleton_num)
-		{
-			Skeleton* skeleton = new Skeleton();
-			skeleton->Read(stream);
-			skeletons.push_back(skeleton);
-		}
-
-		// animations
-		for(Int32 animation_num=0;animation_num<animation_count;++animation_num)
-		{
-			Animation* animation = new Animation();
-			animation->Read(stream);
-			animations[animation->name_id()] = animation;
-		}
-
+		ReadSkeletonsAndAnimations(stream, skeleton_count, animation_count, skeletons, animations);
 
 		return success;
 	}
@@ -312,6 +454,32 @@ namespace gef
 		for(std::list<MeshData>::const_iterator mesh_iter = mesh_data.begin(); mesh_iter != mesh_data.end(); ++mesh_iter)
 			mesh_iter->Write(stream);
 
+		WriteSkeletonsAndAnimations(stream);
+
+		return success;
+	}
+
+	void Scene::ReadSkeletonsAndAnimations(std::istream& stream, Int32 skeleton_count, Int32 animation_count, std::list<Skeleton*>& new_skeletons, std::map<gef::StringId, Animation*>& new_animations)
+	{
+		// skeletons
+		for(Int32 skeleton_num=0;skeleton_num<skeleton_count;++skeleton_num)
+		{
+			Skeleton* skeleton = new Skeleton();
+			skeleton->Read(stream);
+			new_skeletons.push_back(skeleton);
+		}
+
+		// animations
+		for(Int32 animation_num=0;animation_num<animation_count;++animation_num)
+		{
+			Animation* animation = new Animation();
+			animation->Read(stream);
+			new_animations[animation->name_id()] = animation;
+		}
+	}
+
+	void Scene::WriteSkeletonsAndAnimations(std::ostream& stream) const
+	{
 		// skeletons
 		for(std::list<Skeleton*>::const_iterator skeleton_iter = skeletons.begin();skeleton_iter != skeletons.end(); ++skeleton_iter)
 			(*skeleton_iter)->Write(stream);
@@ -319,8 +487,250 @@ namespace gef
 		// animations
 		for(std::map<gef::StringId, Animation*>::const_iterator animation_iter = animations.begin(); animation_iter != animations.end(); ++animation_iter)
 			animation_iter->second->Write(stream);
+	}
 
-		return success;
+	bool Scene::IsMappedScene(const void* data, Int32 size)
+	{
+		if(!data || size < (Int32)sizeof(MappedSceneHeader))
+			return false;
+
+		UInt32 magic;
+		memcpy(&magic, data, sizeof(UInt32));
+		return magic == kMappedSceneMagic;
+	}
+
+	bool Scene::ReadMappedScene(const void* data, Int32 size)
+	{
+		if(!IsMappedScene(data, size))
+			return false;
+
+		const char* file = (const char*)data;
+
+		// records are copied out with memcpy so they don't need to be aligned
+		MappedSceneHeader header;
+		memcpy(&header, file, sizeof(MappedSceneHeader));
+
+		// a different version has a different layout, the file needs to be exported again
+		if(header.version != kMappedSceneVersion || header.file_size > (UInt32)size)
+			return false;
+
+		const UInt32 file_size = header.file_size;
+		if(!InMappedScene(header.materials_offset, header.material_count, sizeof(MappedMaterialRecord), file_size) ||
+			!InMappedScene(header.meshes_offset, header.mesh_count, sizeof(MappedMeshRecord), file_size) ||
+			!InMappedScene(header.stream_offset, header.stream_size, 1, file_size) ||
+			header.string_count < 0 || header.skeleton_count < 0 || header.animation_count < 0)
+			return false;
+
+		// everything is read into containers of its own and only added to the scene once the whole file has been read,
+		// so a bad file doesn't leave the scene half read, or mesh_data pointing into data that is about to be freed
+
+		// string table
+		std::vector<std::string> new_strings;
+		UInt32 string_offset = header.strings_offset;
+		for(Int32 string_num=0;string_num<header.string_count;++string_num)
+		{
+			std::string the_string;
+			if(!ReadMappedString(file, string_offset, file_size, the_string))
+				return false;
+
+			string_offset += (UInt32)the_string.length()+1;
+			new_strings.push_back(the_string);
+		}
+
+		std::list<MaterialData> new_material_data;
+		std::list<MeshData> new_mesh_data;
+
+		// materials
+		for(Int32 material_num=0;material_num<header.material_count;++material_num)
+		{
+			MappedMaterialRecord record;
+			memcpy(&record, file + header.materials_offset + material_num*sizeof(MappedMaterialRecord), sizeof(MappedMaterialRecord));
+
+			new_material_data.push_back(MaterialData());
+			MaterialData& material = new_material_data.back();
+			material.name_id = record.name_id;
+			material.colour = record.colour;
+			if(record.diffuse_texture_offset != 0 && !ReadMappedString(file, record.diffuse_texture_offset, file_size, material.diffuse_texture))
+				return false;
+		}
+
+		// mesh_data, the vertices and indices are used where they are in the file
+		// the file is mapped copy-on-write, so they can still be written to, e.g. by FixUpSkinWeights
+		for(Int32 mesh_num=0;mesh_num<header.mesh_count;++mesh_num)
+		{
+			MappedMeshRecord record;
+			memcpy(&record, file + header.meshes_offset + mesh_num*sizeof(MappedMeshRecord), sizeof(MappedMeshRecord));
+
+			if(record.num_vertices < 0 || record.vertex_byte_size < 0 ||
+				!InMappedScene(record.vertices_offset, record.num_vertices, record.vertex_byte_size, file_size) ||
+				!InMappedScene(record.primitives_offset, record.num_primitives, sizeof(MappedPrimitiveRecord), file_size))
+				return false;
+
+			new_mesh_data.push_back(MeshData());
+			MeshData& mesh = new_mesh_data.back();
+			mesh.name_id = record.name_id;
+			mesh.aabb.Update(gef::Vector4(record.aabb_min[0], record.aabb_min[1], record.aabb_min[2]));
+			mesh.aabb.Update(gef::Vector4(record.aabb_max[0], record.aabb_max[1], record.aabb_max[2]));
+
+			mesh.vertex_data.vertices = const_cast<char*>(file + record.vertices_offset);
+			mesh.vertex_data.owns_vertices = false;
+			mesh.vertex_data.num_vertices = record.num_vertices;
+			mesh.vertex_data.vertex_byte_size = record.vertex_byte_size;
+
+			for(Int32 prim_num=0;prim_num<record.num_primitives;++prim_num)
+			{
+				MappedPrimitiveRecord prim_record;
+				memcpy(&prim_record, file + record.primitives_offset + prim_num*sizeof(MappedPrimitiveRecord), sizeof(MappedPrimitiveRecord));
+
+				if(prim_record.index_byte_size < 0 ||
+					!InMappedScene(prim_record.indices_offset, prim_record.num_indices, prim_record.index_byte_size, file_size))
+					return false;
+
+				PrimitiveData* primitive_data = new PrimitiveData();
+				primitive_data->material_name_id = prim_record.material_name_id;
+				primitive_data->type = (PrimitiveType)prim_record.type;
+				primitive_data->num_indices = prim_record.num_indices;
+				primitive_data->index_byte_size = prim_record.index_byte_size;
+				primitive_data->indices = const_cast<char*>(file + prim_record.indices_offset);
+				primitive_data->owns_indices = false;
+				mesh.primitives.push_back(primitive_data);
+			}
+		}
+
+		// skeletons and animations
+		std::list<Skeleton*> new_skeletons;
+		std::map<gef::StringId, Animation*> new_animations;
+		if(header.stream_size > 0)
+		{
+			gef::MemoryStreamBuffer stream_buffer(const_cast<char*>(file + header.stream_offset), header.stream_size);
+
+			std::istream input_stream(&stream_buffer);
+			ReadSkeletonsAndAnimations(input_stream, header.skeleton_count, header.animation_count, new_skeletons, new_animations);
+
+			// the stream fails if the skeletons and animations run past the end of their data
+			if(input_stream.fail())
+			{
+				for(std::list<Skeleton*>::iterator skeleton_iter = new_skeletons.begin(); skeleton_iter != new_skeletons.end(); ++skeleton_iter)
+					delete *skeleton_iter;
+				for(std::map<gef::StringId, Animation*>::iterator animation_iter = new_animations.begin(); animation_iter != new_animations.end(); ++animation_iter)
+					delete animation_iter->second;
+				return false;
+			}
+		}
+
+		// the whole file is good, add it to the scene
+		for(std::vector<std::string>::const_iterator string_iter = new_strings.begin(); string_iter != new_strings.end(); ++string_iter)
+			string_id_table.Add(*string_iter);
+
+		// splicing keeps the addresses of the elements, so the map can point at them
+		for(std::list<MaterialData>::iterator material_iter = new_material_data.begin(); material_iter != new_material_data.end(); ++material_iter)
+			material_data_map[material_iter->name_id] = &*material_iter;
+		material_data.splice(material_data.end(), new_material_data);
+		mesh_data.splice(mesh_data.end(), new_mesh_data);
+
+		skeletons.splice(skeletons.end(), new_skeletons);
+		for(std::map<gef::StringId, Animation*>::iterator animation_iter = new_animations.begin(); animation_iter != new_animations.end(); ++animation_iter)
+			animations[animation_iter->first] = animation_iter->second;
+
+		return true;
+	}
+
+	bool Scene::WriteMappedScene(std::ostream& stream) const
+	{
+		std::vector<char> buffer;
+
+		MappedSceneHeader header;
+		memset(&header, 0, sizeof(MappedSceneHeader));
+		header.magic = kMappedSceneMagic;
+		header.version = kMappedSceneVersion;
+		header.string_count = (Int32)string_id_table.table().size();
+		header.material_count = (Int32)material_data.size();
+		header.mesh_count = (Int32)mesh_data.size();
+		header.skeleton_count = (Int32)skeletons.size();
+		header.animation_count = (Int32)animations.size();
+		buffer.resize(sizeof(MappedSceneHeader));
+
+		Int32 primitive_count = 0;
+		for(std::list<MeshData>::const_iterator mesh_iter = mesh_data.begin(); mesh_iter != mesh_data.end(); ++mesh_iter)
+			primitive_count += (Int32)mesh_iter->primitives.size();
+
+		// make space for the records, they are filled in as the data they refer to is added
+		header.materials_offset = AppendMappedData(buffer, NULL, header.material_count*sizeof(MappedMaterialRecord), sizeof(UInt32));
+		header.meshes_offset = AppendMappedData(buffer, NULL, header.mesh_count*sizeof(MappedMeshRecord), sizeof(UInt32));
+		UInt32 primitives_offset = AppendMappedData(buffer, NULL, primitive_count*sizeof(MappedPrimitiveRecord), sizeof(UInt32));
+
+		// string table
+		header.strings_offset = (UInt32)buffer.size();
+		for(std::map<gef::StringId, std::string>::const_iterator string_iter = string_id_table.table().begin(); string_iter != string_id_table.table().end(); ++string_iter)
+			AppendMappedData(buffer, string_iter->second.c_str(), string_iter->second.length()+1, 1);
+
+		// materials
+		Int32 material_num = 0;
+		for(std::list<MaterialData>::const_iterator material_iter = material_data.begin(); material_iter != material_data.end(); ++material_iter, ++material_num)
+		{
+			MappedMaterialRecord record;
+			record.name_id = material_iter->name_id;
+			record.colour = material_iter->colour;
+			record.diffuse_texture_offset = 0;
+			if(material_iter->diffuse_texture != "")
+				record.diffuse_texture_offset = AppendMappedData(buffer, material_iter->diffuse_texture.c_str(), material_iter->diffuse_texture.length()+1, 1);
+
+			memcpy(&buffer[header.materials_offset + material_num*sizeof(MappedMaterialRecord)], &record, sizeof(MappedMaterialRecord));
+		}
+
+		// mesh_data
+		Int32 mesh_num = 0;
+		Int32 prim_num = 0;
+		for(std::list<MeshData>::const_iterator mesh_iter = mesh_data.begin(); mesh_iter != mesh_data.end(); ++mesh_iter, ++mesh_num)
+		{
+			const MeshData& mesh = *mesh_iter;
+
+			MappedMeshRecord record;
+			record.name_id = mesh.name_id;
+			record.aabb_min[0] = mesh.aabb.min_vtx().x();
+			record.aabb_min[1] = mesh.aabb.min_vtx().y();
+			record.aabb_min[2] = mesh.aabb.min_vtx().z();
+			record.aabb_max[0] = mesh.aabb.max_vtx().x();
+			record.aabb_max[1] = mesh.aabb.max_vtx().y();
+			record.aabb_max[2] = mesh.aabb.max_vtx().z();
+			record.num_vertices = mesh.vertex_data.num_vertices;
+			record.vertex_byte_size = mesh.vertex_data.vertex_byte_size;
+			record.vertices_offset = AppendMappedData(buffer, mesh.vertex_data.vertices, mesh.vertex_data.num_vertices*mesh.vertex_data.vertex_byte_size, kMappedSceneDataAlignment);
+			record.num_primitives = (Int32)mesh.primitives.size();
+			record.primitives_offset = primitives_offset + prim_num*sizeof(MappedPrimitiveRecord);
+
+			for(std::vector<PrimitiveData*>::const_iterator prim_iter = mesh.primitives.begin(); prim_iter != mesh.primitives.end(); ++prim_iter, ++prim_num)
+			{
+				const PrimitiveData* primitive = *prim_iter;
+
+				MappedPrimitiveRecord prim_record;
+				prim_record.material_name_id = primitive->material_name_id;
+				prim_record.type = (Int32)primitive->type;
+				prim_record.num_indices = primitive->num_indices;
+				prim_record.index_byte_size = primitive->index_byte_size;
+				prim_record.indices_offset = AppendMappedData(buffer, primitive->indices, primitive->num_indices*primitive->index_byte_size, kMappedSceneDataAlignment);
+
+				memcpy(&buffer[primitives_offset + prim_num*sizeof(MappedPrimitiveRecord)], &prim_record, sizeof(MappedPrimitiveRecord));
+			}
+
+			memcpy(&buffer[header.meshes_offset + mesh_num*sizeof(MappedMeshRecord)], &record, sizeof(MappedMeshRecord));
+		}
+
+		// skeletons and animations
+		std::ostringstream skeleton_stream(std::ios::out | std::ios::binary);
+		WriteSkeletonsAndAnimations(skeleton_stream);
+		const std::string skeleton_data = skeleton_stream.str();
+		header.stream_size = (UInt32)skeleton_data.size();
+		header.stream_offset = AppendMappedData(buffer, skeleton_data.data(), skeleton_data.size(), kMappedSceneDataAlignment);
+
+		// pad the end so the last block of data is a whole number of aligned blocks
+		AppendMappedData(buffer, NULL, 0, kMappedSceneDataAlignment);
+
+		header.file_size = (UInt32)buffer.size();
+		memcpy(&buffer[0], &header, sizeof(MappedSceneHeader));
+
+		stream.write(&buffer[0], buffer.size());
+		return stream.good();
 	}
 
 	Skeleton* Scene::FindSkeleton(const MeshData& mesh_data)
@@ -15,21 +15,40 @@ namespace gef
 	class Animation;
 	class Platform;
 	class Material;
+	class MappedFile;
+	class ImageData;
 
 	class Scene
 	{
 	public:
+		Scene();
 		~Scene();
 
 		Mesh* CreateMesh(Platform& platform, const MeshData& mesh_data, const bool read_only = true);
 		void CreateMeshes(Platform& platform, const bool read_only = true);
 		void CreateMaterials(const Platform& platform);
 
+		// Decode the PNG of every material's diffuse texture into texture_images, so CreateMaterials only
+		// has to create the textures. Nothing else in the scene is changed, so it can be run on another thread.
+		void ReadTextureImages(const Platform& platform);
+
+		// ReadSceneFromFile reads both file formats. Mapped scene files are kept mapped while
+		// the scene exists, and the vertices and indices in mesh_data point straight into them.
+		// Reading more than one file into a scene keeps every mapping.
 		bool WriteSceneToFile(const Platform& platform, const char* filename) const;
+		bool WriteMappedSceneToFile(const Platform& platform, const char* filename) const;
 		bool ReadSceneFromFile(const Platform& platform, const char* filename);
 
 		bool ReadScene(std::istream& Stream);
 		bool WriteScene(std::ostream& Stream) const;
+
+		// Mapped scene format. The data must stay valid for as long as the scene uses mesh_data,
+		// and must be writable if it is modified through mesh_data (e.g. by FixUpSkinWeights).
+		// ReadSceneFromFile maps files copy-on-write, so its scenes can be.
+		// Nothing is added to the scene if the data can't be read.
+		bool ReadMappedScene(const void* data, Int32 size);
+		bool WriteMappedScene(std::ostream& stream) const;
+		static bool IsMappedScene(const void* data, Int32 size);
 //		void WriteStringTable(std::istream& Stream) const;
 //		void ReadStringTable(std::istream& Stream);
 
@@ -51,7 +70,16 @@ namespace gef
 		std::map<gef::StringId, Material*> materials_map;
 		std::map<gef::StringId, Texture*> textures_map;
 
+		// decoded by ReadTextureImages and freed by CreateMaterials, NULL for a texture that couldn't be read
+		std::map<gef::StringId, ImageData*> texture_images;
+
 		std::vector<gef::StringId> skin_cluster_name_ids;
+
+	private:
+		void ReadSkeletonsAndAnimations(std::istream& stream, Int32 skeleton_count, Int32 animation_count, std::list<Skeleton*>& new_skeletons, std::map<gef::StringId, Animation*>& new_animations);
+		void WriteSkeletonsAndAnimations(std::ostream& stream) const;
+
+		std::vector<MappedFile*> mapped_files_;	// every mapped file read into the scene
 	};
 }
 
@@ -0,0 +1,105 @@
+#include <graphics/scene_cache.h>
+#include <graphics/scene.h>
+#include <graphics/mesh.h>
+#include <graphics/material.h>
+#include <graphics/texture.h>
+#include <system/profiler.h>
+
+namespace gef
+{
+	SceneCache::SceneCache(Platform& platform) :
+		platform_(platform)
+	{
+	}
+
+	SceneCache::~SceneCache()
+	{
+		Clear();
+	}
+
+	Scene* SceneCache::LoadScene(const char* filename)
+	{
+		GEF_PROFILE_ZONE("SceneCache::LoadScene");
+		std::map<StringId, Scene*>::const_iterator find_result = scenes_.find(GetStringId(filename));
+		if(find_result != scenes_.end())
+			return find_result->second;
+
+		Scene* scene = new Scene();
+		if(!scene->ReadSceneFromFile(platform_, filename))
+		{
+			delete scene;
+			scene = NULL;
+		}
+
+		return AddScene(filename, scene);
+	}
+
+	Scene* SceneCache::AddScene(const char* filename, Scene* scene)
+	{
+		const StringId scene_name_id = GetStringId(filename);
+
+		std::map<StringId, Scene*>::const_iterator find_result = scenes_.find(scene_name_id);
+		if(find_result != scenes_.end())
+		{
+			delete scene;
+			return find_result->second;
+		}
+
+		if(scene)
+		{
+			// give the scene the textures already loaded so only new ones are created,
+			// scenes only delete the textures in their own textures list
+			scene->textures_map = textures_;
+			scene->CreateMaterials(platform_);
+			scene->CreateMeshes(platform_);
+
+			textures_.insert(scene->textures_map.begin(), scene->textures_map.end());
+			materials_.insert(scene->materials_map.begin(), scene->materials_map.end());
+
+			std::list<MeshData>::const_iterator mesh_data_iter = scene->mesh_data.begin();
+			for(std::list<Mesh*>::const_iterator mesh_iter = scene->meshes.begin(); mesh_iter != scene->meshes.end(); ++mesh_iter, ++mesh_data_iter)
+				meshes_.insert(std::make_pair(mesh_data_iter->name_id, *mesh_iter));
+		}
+
+		scenes_[scene_name_id] = scene;
+		return scene;
+	}
+
+	bool SceneCache::HasScene(const char* filename) const
+	{
+		return scenes_.find(GetStringId(filename)) != scenes_.end();
+	}
+
+	Mesh* SceneCache::LoadMesh(const char* filename)
+	{
+		Scene* scene = LoadScene(filename);
+		if(!scene || scene->meshes.empty())
+			return NULL;
+
+		return scene->meshes.front();
+	}
+
+	Mesh* SceneCache::FindMesh(const StringId mesh_name_id) const
+	{
+		std::map<StringId, Mesh*>::const_iterator find_result = meshes_.find(mesh_name_id);
+		return find_result != meshes_.end() ? find_result->second : NULL;
+	}
+
+	Material* SceneCache::FindMaterial(const StringId material_name_id) const
+	{
+		std::map<StringId, Material*>::const_iterator find_result = materials_.find(material_name_id);
+		return find_result != materials_.end() ? find_result->second : NULL;
+	}
+
+	void SceneCache::Clear()
+	{
+		// the scenes own everything else in the cache
+		for(std::map<StringId, Scene*>::iterator scene_iter = scenes_.begin(); scene_iter != scenes_.end(); ++scene_iter)
+			delete scene_iter->second;
+
+		scenes_.clear();
+		meshes_.clear();
+		materials_.clear();
+		textures_.clear();
+	}
+}
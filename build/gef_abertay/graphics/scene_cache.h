@@ -0,0 +1,57 @@
+#ifndef _GEF_SCENE_CACHE_H
+#define _GEF_SCENE_CACHE_H
+
+#include <gef.h>
+#include <system/string_id.h>
+#include <map>
+
+namespace gef
+{
+	class Platform;
+	class Scene;
+	class Mesh;
+	class Material;
+	class Texture;
+
+	// Loads scene files and keeps them, along with the meshes, materials and textures
+	// created from them, so loading the same file again doesn't read or upload anything.
+	// Scenes are keyed on the string id of the filename, meshes and materials on their name ids.
+	// Textures are shared between scenes that use the same texture file.
+	// Everything returned is owned by the cache and is released by Clear or when the cache is deleted.
+	class SceneCache
+	{
+	public:
+		SceneCache(Platform& platform);
+		~SceneCache();
+
+		// Returns the scene with its meshes and materials created, or NULL if the file couldn't be read.
+		// A file that fails to load isn't tried again.
+		Scene* LoadScene(const char* filename);
+
+		// Returns the first mesh in the scene file, or NULL if there isn't one.
+		Mesh* LoadMesh(const char* filename);
+
+		// For scenes read somewhere else, e.g. on another thread. AddScene creates the meshes and materials
+		// and takes ownership of the scene, pass NULL to record that the file failed to load.
+		// Textures are created from the scene's texture_images where Scene::ReadTextureImages has decoded them.
+		// If the file is already in the cache the scene passed in is deleted and the cached one is returned.
+		Scene* AddScene(const char* filename, Scene* scene);
+		bool HasScene(const char* filename) const;
+
+		Mesh* FindMesh(const StringId mesh_name_id) const;
+		Material* FindMaterial(const StringId material_name_id) const;
+
+		void Clear();
+
+		inline Int32 num_scenes() const { return (Int32)scenes_.size(); }
+	private:
+		Platform& platform_;
+
+		std::map<StringId, Scene*> scenes_;
+		std::map<StringId, Mesh*> meshes_;
+		std::map<StringId, Material*> materials_;
+		std::map<StringId, Texture*> textures_;
+	};
+}
+
+#endif // _GEF_SCENE_CACHE_H
@@ -54,6 +54,14 @@ namespace gef
 
 	bool Shader::LoadShader(const char* filename, const char* base_filepath, char** shader_source, Int32& shader_source_length, const Platform& platform)
 	{
+		// platforms without a shader directory (e.g. the null platform) have no shader source to load
+		if (platform.GetShaderDirectory() == NULL)
+		{
+			*shader_source = NULL;
+			shader_source_length = 0;
+			return false;
+		}
+
 		File* vs_file = gef::File::Create();
 		void* buffer = NULL;
 		Int32 buffer_size = 0;
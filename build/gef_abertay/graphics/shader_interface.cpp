@@ -86,6 +86,19 @@ namespace gef
 		shader_parameter.byte_offset = parameter_byte_offset;
 		shader_parameter.semantic_name = semantic_name;
 		shader_parameter.semantic_index = semantic_index;
+		shader_parameter.per_instance = false;
+		parameters_.push_back(shader_parameter);
+	}
+
+	void ShaderInterface::AddInstanceParameter(const char* parameter_name, VariableType parameter_type, Int32 parameter_byte_offset, const char* semantic_name, int semantic_index)
+	{
+		ShaderParameter shader_parameter;
+		shader_parameter.name = parameter_name;
+		shader_parameter.type = parameter_type;
+		shader_parameter.byte_offset = parameter_byte_offset;
+		shader_parameter.semantic_name = semantic_name;
+		shader_parameter.semantic_index = semantic_index;
+		shader_parameter.per_instance = true;
 		parameters_.push_back(shader_parameter);
 	}
 
@@ -104,6 +117,10 @@ namespace gef
 		texture_sampler.texture = texture;
 	}
 
+	void ShaderInterface::AddSamplerState(SamplerAddressMode address_mode)
+	{
+	}
+
 	Int32 ShaderInterface::GetTypeSize(VariableType type)
 	{
 		Int32 size;
@@ -31,6 +31,12 @@ namespace gef
 //			kNumParameterTypes
 		};
 
+		enum SamplerAddressMode
+		{
+			kWrap = 0,
+			kClamp
+		};
+
 		struct ShaderVariable
 		{
 			std::string name;
@@ -46,6 +52,7 @@ namespace gef
 			Int32 byte_offset;
 			std::string semantic_name;
 			Int32 semantic_index;
+			bool per_instance;
 		};
 
 		struct TextureSampler
@@ -64,6 +71,7 @@ namespace gef
 		virtual void CreateVertexFormat() = 0;
 
 		void AddVertexParameter(const char* parameter_name, VariableType variable_type, Int32 byte_offset, const char* semantic_name, int semantic_index);
+		void AddInstanceParameter(const char* parameter_name, VariableType variable_type, Int32 byte_offset, const char* semantic_name, int semantic_index);
 		inline void set_vertex_size(Int32 vertex_size) {vertex_size_ = vertex_size; }
 
 		Int32 AddVertexShaderVariable(const char* variable_name, VariableType variable_type, Int32 variable_count = 1);
@@ -74,6 +82,9 @@ namespace gef
 		Int32 AddTextureSampler(const char* texture_sampler_name);
 		void SetTextureSampler(Int32 texture_sampler_index, const Texture* texture);
 
+		// adds a linear filtered sampler state, platforms without sampler state objects can ignore this
+		virtual void AddSamplerState(SamplerAddressMode address_mode);
+
 		virtual void UseProgram() = 0;
 
 		virtual void SetVariableData() = 0;
@@ -1,6 +1,7 @@
 #include <graphics/texture.h>
 #include <graphics/image_data.h>
 #include <system/platform.h>
+#include <cstdlib>
 
 namespace gef
 {
@@ -19,7 +20,7 @@ namespace gef
 	Texture* Texture::CreateCheckerTexture(const Int32 size, const Int32 num_checkers, const Platform& platform)
 	{
 		const UInt32 check_size = size / num_checkers;
-		UInt32* checker_texture = new UInt32[size*size];
+		UInt32* checker_texture = (UInt32*)malloc(size*size*sizeof(UInt32));
 
 		const UInt32 kBlack = 0xff000000;
 		const UInt32 kWhite = 0xffffffff;
@@ -2,6 +2,7 @@
 #include <maths/matrix44.h>
 #include <maths/sphere.h>
 #include <maths/aabb.h>
+#include <maths/maths_kernels.h>
 #include <math.h>
 
 namespace gef
@@ -84,6 +85,11 @@ namespace gef
 
 	}
 
+	void Frustum::Intersects(const Aabb* aabbs, FrustumIntersect* results, Int32 num_aabbs) const
+	{
+		kernels::FrustumIntersects(planes_, aabbs, results, num_aabbs);
+	}
+
 	//
 	// http://gamedevs.org/uploads/fast-extraction-viewing-frustum-planes-from-world-view-projection-matrix.pdf
 	//
@@ -91,35 +97,35 @@ namespace gef
 	void Frustum::ExtractPlanesD3D(const Matrix44& viewproj, bool normalise)
 	{
 		// Left clipping plane
-		planes_[0].set_a(viewproj.m(0,3) + viewproj.m(0,0));
-		planes_[0].set_b(viewproj.m(1,3) + viewproj.m(1,0));
-		planes_[0].set_c(viewproj.m(2,3) + viewproj.m(2,0));
-		planes_[0].set_d(viewproj.m(3,3) + viewproj.m(3,0));
+		planes_[FP_LEFT].set_a(viewproj.m(0,3) + viewproj.m(0,0));
+		planes_[FP_LEFT].set_b(viewproj.m(1,3) + viewproj.m(1,0));
+		planes_[FP_LEFT].set_c(viewproj.m(2,3) + viewproj.m(2,0));
+		planes_[FP_LEFT].set_d(viewproj.m(3,3) + viewproj.m(3,0));
 		// Right clipping plane
-		planes_[0].set_a(viewproj.m(0,3) - viewproj.m(0,0));
-		planes_[0].set_b(viewproj.m(1,3) - viewproj.m(1,0));
-		planes_[0].set_c(viewproj.m(2,3) - viewproj.m(2,0));
-		planes_[0].set_d(viewproj.m(3,3) - viewproj.m(3,0));
+		planes_[FP_RIGHT].set_a(viewproj.m(0,3) - viewproj.m(0,0));
+		planes_[FP_RIGHT].set_b(viewproj.m(1,3) - viewproj.m(1,0));
+		planes_[FP_RIGHT].set_c(viewproj.m(2,3) - viewproj.m(2,0));
+		planes_[FP_RIGHT].set_d(viewproj.m(3,3) - viewproj.m(3,0));
 		// Top clipping plane
-		planes_[1].set_a(viewproj.m(0,3) - viewproj.m(0,1));
-		planes_[1].set_b(viewproj.m(1,3) - viewproj.m(1,1));
-		planes_[1].set_c(viewproj.m(2,3) - viewproj.m(2,1));
-		planes_[1].set_d(viewproj.m(3,3) - viewproj.m(3,1));
+		planes_[FP_TOP].set_a(viewproj.m(0,3) - viewproj.m(0,1));
+		planes_[FP_TOP].set_b(viewproj.m(1,3) - viewproj.m(1,1));
+		planes_[FP_TOP].set_c(viewproj.m(2,3) - viewproj.m(2,1));
+		planes_[FP_TOP].set_d(viewproj.m(3,3) - viewproj.m(3,1));
 		// Bottom clipping plane
-		planes_[2].set_a(viewproj.m(0,3) + viewproj.m(0,1));
-		planes_[2].set_b(viewproj.m(1,3) + viewproj.m(1,1));
-		planes_[2].set_c(viewproj.m(2,3) + viewproj.m(2,1));
-		planes_[2].set_d(viewproj.m(3,3) + viewproj.m(3,1));
+		planes_[FP_BOTTOM].set_a(viewproj.m(0,3) + viewproj.m(0,1));
+		planes_[FP_BOTTOM].set_b(viewproj.m(1,3) + viewproj.m(1,1));
+		planes_[FP_BOTTOM].set_c(viewproj.m(2,3) + viewproj.m(2,1));
+		planes_[FP_BOTTOM].set_d(viewproj.m(3,3) + viewproj.m(3,1));
 		// Near clipping plane
-		planes_[3].set_a(viewproj.m(0,2));
-		planes_[3].set_b(viewproj.m(1,2));
-		planes_[3].set_c(viewproj.m(2,2));
-		planes_[3].set_d(viewproj.m(3,2));
+		planes_[FP_NEAR].set_a(viewproj.m(0,2));
+		planes_[FP_NEAR].set_b(viewproj.m(1,2));
+		planes_[FP_NEAR].set_c(viewproj.m(2,2));
+		planes_[FP_NEAR].set_d(viewproj.m(3,2));
 		// Far clipping plane
-		planes_[5].set_a(viewproj.m(0,3) - viewproj.m(0,2));
-		planes_[5].set_b(viewproj.m(1,3) - viewproj.m(1,2));
-		planes_[5].set_c(viewproj.m(2,3) - viewproj.m(2,2));
-		planes_[5].set_d(viewproj.m(3,3) - viewproj.m(3,2));
+		planes_[FP_FAR].set_a(viewproj.m(0,3) - viewproj.m(0,2));
+		planes_[FP_FAR].set_b(viewproj.m(1,3) - viewproj.m(1,2));
+		planes_[FP_FAR].set_c(viewproj.m(2,3) - viewproj.m(2,2));
+		planes_[FP_FAR].set_d(viewproj.m(3,3) - viewproj.m(3,2));
 		// Normalize the plane equations, if requested
 		if (normalise == true)
 		{
@@ -136,35 +142,35 @@ namespace gef
 	void Frustum::ExtractPlanesGL(const Matrix44& viewproj, bool normalise)
 	{
 		// Left clipping plane
-		planes_[0].set_a(viewproj.m(3,0) + viewproj.m(0,0));
-		planes_[0].set_b(viewproj.m(3,1) + viewproj.m(0,1));
-		planes_[0].set_c(viewproj.m(3,2) + viewproj.m(0,2));
-		planes_[0].set_d(viewproj.m(3,3) + viewproj.m(0,3));
+		planes_[FP_LEFT].set_a(viewproj.m(3,0) + viewproj.m(0,0));
+		planes_[FP_LEFT].set_b(viewproj.m(3,1) + viewproj.m(0,1));
+		planes_[FP_LEFT].set_c(viewproj.m(3,2) + viewproj.m(0,2));
+		planes_[FP_LEFT].set_d(viewproj.m(3,3) + viewproj.m(0,3));
 		// Right clipping plane
-		planes_[0].set_a(viewproj.m(3,0) - viewproj.m(0,0));
-		planes_[0].set_b(viewproj.m(3,1) - viewproj.m(0,1));
-		planes_[0].set_c(viewproj.m(3,2) - viewproj.m(0,2));
-		planes_[0].set_d(viewproj.m(3,3) - viewproj.m(0,3));
+		planes_[FP_RIGHT].set_a(viewproj.m(3,0) - viewproj.m(0,0));
+		planes_[FP_RIGHT].set_b(viewproj.m(3,1) - viewproj.m(0,1));
+		planes_[FP_RIGHT].set_c(viewproj.m(3,2) - viewproj.m(0,2));
+		planes_[FP_RIGHT].set_d(viewproj.m(3,3) - viewproj.m(0,3));
 		// Top clipping plane
-		planes_[1].set_a(viewproj.m(3,0) - viewproj.m(1,0));
-		planes_[1].set_b(viewproj.m(3,1) - viewproj.m(1,1));
-		planes_[1].set_c(viewproj.m(3,2) - viewproj.m(1,2));
-		planes_[1].set_d(viewproj.m(3,3) - viewproj.m(1,3));
+		planes_[FP_TOP].set_a(viewproj.m(3,0) - viewproj.m(1,0));
+		planes_[FP_TOP].set_b(viewproj.m(3,1) - viewproj.m(1,1));
+		planes_[FP_TOP].set_c(viewproj.m(3,2) - viewproj.m(1,2));
+		planes_[FP_TOP].set_d(viewproj.m(3,3) - viewproj.m(1,3));
 		// Bottom clipping plane
-		planes_[2].set_a(viewproj.m(3,0) + viewproj.m(1,0));
-		planes_[2].set_b(viewproj.m(3,1) + viewproj.m(1,1));
-		planes_[2].set_c(viewproj.m(3,2) + viewproj.m(1,2));
-		planes_[2].set_d(viewproj.m(3,3) + viewproj.m(1,3));
+		planes_[FP_BOTTOM].set_a(viewproj.m(3,0) + viewproj.m(1,0));
+		planes_[FP_BOTTOM].set_b(viewproj.m(3,1) + viewproj.m(1,1));
+		planes_[FP_BOTTOM].set_c(viewproj.m(3,2) + viewproj.m(1,2));
+		planes_[FP_BOTTOM].set_d(viewproj.m(3,3) + viewproj.m(1,3));
 		// Near clipping plane
-		planes_[3].set_a(viewproj.m(3,0) + viewproj.m(2,0));
-		planes_[3].set_b(viewproj.m(3,1) + viewproj.m(2,1));
-		planes_[3].set_c(viewproj.m(3,2) + viewproj.m(2,2));
-		planes_[3].set_d(viewproj.m(3,3) + viewproj.m(2,3));
+		planes_[FP_NEAR].set_a(viewproj.m(3,0) + viewproj.m(2,0));
+		planes_[FP_NEAR].set_b(viewproj.m(3,1) + viewproj.m(2,1));
+		planes_[FP_NEAR].set_c(viewproj.m(3,2) + viewproj.m(2,2));
+		planes_[FP_NEAR].set_d(viewproj.m(3,3) + viewproj.m(2,3));
 		// Far clipping plane
-		planes_[5].set_a(viewproj.m(3,0) - viewproj.m(2,0));
-		planes_[5].set_b(viewproj.m(3,1) - viewproj.m(2,1));
-		planes_[5].set_c(viewproj.m(3,2) - viewproj.m(2,2));
-		planes_[5].set_d(viewproj.m(3,3) - viewproj.m(2,3));
+		planes_[FP_FAR].set_a(viewproj.m(3,0) - viewproj.m(2,0));
+		planes_[FP_FAR].set_b(viewproj.m(3,1) - viewproj.m(2,1));
+		planes_[FP_FAR].set_c(viewproj.m(3,2) - viewproj.m(2,2));
+		planes_[FP_FAR].set_d(viewproj.m(3,3) - viewproj.m(2,3));
 		// Normalize the plane equations, if requested
 		if (normalise == true)
 		{
@@ -1,6 +1,7 @@
 #ifndef _GEF_MATHS_FRUSTUM_H
 #define _GEF_MATHS_FRUSTUM_H
 
+#include <gef.h>
 #include <maths/plane.h>
 
 namespace gef
@@ -31,6 +32,16 @@ namespace gef
 	public:
 		FrustumIntersect Intersects(const Sphere& sphere) const;
 		FrustumIntersect Intersects(const Aabb& aabb) const;
+
+		/// @brief Test an array of AABBs against this frustum in one batch.
+		/// @param[in] aabbs		The bounding boxes to be tested.
+		/// @param[out] results		The result of the test for each bounding box.
+		/// @param[in] num_aabbs	The number of bounding boxes.
+		void Intersects(const Aabb* aabbs, FrustumIntersect* results, Int32 num_aabbs) const;
+
+		/// @brief Get one of the planes of this frustum.
+		/// @param[in] plane	The plane to get.
+		inline const Plane& plane(FrustumPlane plane) const { return planes_[plane]; }
 		void ExtractPlanesD3D(const Matrix44& viewproj, bool normalise);
 		void ExtractPlanesGL(const Matrix44& viewproj, bool normalise);
 	protected:
@@ -0,0 +1,63 @@
+#ifndef _GEF_MATHS_KERNELS_H
+#define _GEF_MATHS_KERNELS_H
+
+#include <gef.h>
+#include <maths/simd.h>
+#include <maths/frustum.h>
+
+namespace gef
+{
+	class Matrix44;
+	class Vector4;
+	class Plane;
+	class Aabb;
+
+	// The functions in the scalar and simd namespaces do the same work with different instruction sets.
+	// The maths classes call them through the kernels namespace, which is simd when GEF_SIMD_SSE is defined and scalar otherwise.
+	// Both sets are public so the two code paths can be compared against each other.
+
+	namespace scalar
+	{
+		/// @brief Calculate the product of two matrices.
+		/// @param[out] result	The product left * right. Can be the same matrix as either operand.
+		/// @param[in] left		The first operand.
+		/// @param[in] right	The second operand.
+		void MatrixMultiply(Matrix44& result, const Matrix44& left, const Matrix44& right);
+
+		/// @brief Calculate the inverse of a matrix.
+		/// @param[out] result			The inverse. Left unaltered if the matrix can't be inverted.
+		/// @param[in] matrix			The matrix to be inverted. Must not be the same matrix as result.
+		/// @param[out] determinant		The determinant of the matrix. This can be set to NULL if it's not required.
+		void MatrixInverse(Matrix44& result, const Matrix44& matrix, float* determinant);
+
+		/// @brief Transform an array of points by a matrix.
+		/// @param[in] matrix		The transformation matrix.
+		/// @param[in] points		The points to be transformed. The w component is ignored and treated as 1.
+		/// @param[out] results		The transformed points. Can be the same array as points.
+		/// @param[in] num_points	The number of points in the arrays.
+		void TransformPoints(const Matrix44& matrix, const Vector4* points, Vector4* results, Int32 num_points);
+
+		/// @brief Test an array of AABBs against the planes of a frustum.
+		/// @param[in] planes		The NUM_FRUSTUM_PLANES frustum planes, normals pointing into the frustum.
+		/// @param[in] aabbs		The bounding boxes to be tested.
+		/// @param[out] results		The result of the test for each bounding box.
+		/// @param[in] num_aabbs	The number of bounding boxes.
+		void FrustumIntersects(const Plane* planes, const Aabb* aabbs, FrustumIntersect* results, Int32 num_aabbs);
+	}
+
+#ifdef GEF_SIMD_SSE
+	namespace simd
+	{
+		void MatrixMultiply(Matrix44& result, const Matrix44& left, const Matrix44& right);
+		void MatrixInverse(Matrix44& result, const Matrix44& matrix, float* determinant);
+		void TransformPoints(const Matrix44& matrix, const Vector4* points, Vector4* results, Int32 num_points);
+		void FrustumIntersects(const Plane* planes, const Aabb* aabbs, FrustumIntersect* results, Int32 num_aabbs);
+	}
+
+	namespace kernels = simd;
+#else
+	namespace kernels = scalar;
+#endif
+}
+
+#endif // _GEF_MATHS_KERNELS_H
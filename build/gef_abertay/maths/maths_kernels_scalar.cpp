@@ -0,0 +1,119 @@
+#include <maths/maths_kernels.h>
+#include <maths/matrix44.h>
+#include <maths/vector4.h>
+#include <maths/plane.h>
+#include <maths/aabb.h>
+#include <math.h>
+
+namespace gef
+{
+	namespace scalar
+	{
+		void MatrixMultiply(Matrix44& result, const Matrix44& left, const Matrix44& right)
+		{
+			// build the product in a temporary so either operand can also be the result
+			Matrix44 product;
+
+			for (int i = 0; i < 4; i++)
+			{
+				const Vector4& row = left.GetRow(i);
+				product.SetRow(i, Vector4(
+					row.x() * right.m(0, 0) + row.y() * right.m(1, 0) + row.z() * right.m(2, 0) + row.w() * right.m(3, 0),
+					row.x() * right.m(0, 1) + row.y() * right.m(1, 1) + row.z() * right.m(2, 1) + row.w() * right.m(3, 1),
+					row.x() * right.m(0, 2) + row.y() * right.m(1, 2) + row.z() * right.m(2, 2) + row.w() * right.m(3, 2),
+					row.x() * right.m(0, 3) + row.y() * right.m(1, 3) + row.z() * right.m(2, 3) + row.w() * right.m(3, 3)));
+			}
+
+			result = product;
+		}
+
+		void MatrixInverse(Matrix44& result, const Matrix44& matrix, float* determinant)
+		{
+			int a, i, j;
+			Vector4 v, vec[3];
+			float det;
+
+			det = matrix.CalculateDeterminant();
+			if ( det!= 0.0f )
+			{
+				for (i=0; i<4; i++)
+				{
+					for (j=0; j<4; j++)
+					{
+						if (j != i )
+						{
+							a = j;
+							if ( j > i )
+								a = a-1;
+
+							vec[a] = matrix.GetRow(j);
+						}
+					}
+
+					v = vec[0].CrossProduct3(vec[1], vec[2]);
+
+
+					float temp = powf(-1.0f, (float)i) / det;
+					result.SetColumn(i, Vector4(temp*v.x(), temp*v.y(), temp*v.z(), temp*v.w()));
+				}
+			}
+
+			if(determinant)
+				*determinant = det;
+		}
+
+		void TransformPoints(const Matrix44& matrix, const Vector4* points, Vector4* results, Int32 num_points)
+		{
+			for (Int32 point_num = 0; point_num < num_points; ++point_num)
+			{
+				const float x = points[point_num].x();
+				const float y = points[point_num].y();
+				const float z = points[point_num].z();
+
+				results[point_num] = Vector4(
+					x * matrix.m(0, 0) + y * matrix.m(1, 0) + z * matrix.m(2, 0) + matrix.m(3, 0),
+					x * matrix.m(0, 1) + y * matrix.m(1, 1) + z * matrix.m(2, 1) + matrix.m(3, 1),
+					x * matrix.m(0, 2) + y * matrix.m(1, 2) + z * matrix.m(2, 2) + matrix.m(3, 2),
+					x * matrix.m(0, 3) + y * matrix.m(1, 3) + z * matrix.m(2, 3) + matrix.m(3, 3));
+			}
+		}
+
+		void FrustumIntersects(const Plane* planes, const Aabb* aabbs, FrustumIntersect* results, Int32 num_aabbs)
+		{
+			for (Int32 aabb_num = 0; aabb_num < num_aabbs; ++aabb_num)
+			{
+				const Vector4& min_vtx = aabbs[aabb_num].min_vtx();
+				const Vector4& max_vtx = aabbs[aabb_num].max_vtx();
+
+				// test the box as a centre point and half extents
+				const float centre_x = (min_vtx.x() + max_vtx.x()) * 0.5f;
+				const float centre_y = (min_vtx.y() + max_vtx.y()) * 0.5f;
+				const float centre_z = (min_vtx.z() + max_vtx.z()) * 0.5f;
+				const float extent_x = (max_vtx.x() - min_vtx.x()) * 0.5f;
+				const float extent_y = (max_vtx.y() - min_vtx.y()) * 0.5f;
+				const float extent_z = (max_vtx.z() - min_vtx.z()) * 0.5f;
+
+				bool out = false;
+				bool intersects = false;
+				for (int p = 0; p < NUM_FRUSTUM_PLANES; ++p)
+				{
+					const Plane& plane = planes[p];
+
+					// distance from the plane to the centre and to the corner furthest along the plane normal
+					float distance = plane.a() * centre_x + plane.b() * centre_y + plane.c() * centre_z + plane.d();
+					float radius = fabsf(plane.a()) * extent_x + fabsf(plane.b()) * extent_y + fabsf(plane.c()) * extent_z;
+
+					// every corner is behind this plane
+					if (distance + radius < 0.0f)
+						out = true;
+
+					// at least one corner is behind this plane
+					if (distance - radius < 0.0f)
+						intersects = true;
+				}
+
+				results[aabb_num] = out ? FI_OUT : (intersects ? FI_INTERSECTS : FI_IN);
+			}
+		}
+	}
+}
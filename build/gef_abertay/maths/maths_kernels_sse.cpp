@@ -0,0 +1,214 @@
+#include <maths/maths_kernels.h>
+
+#ifdef GEF_SIMD_SSE
+
+#include <maths/matrix44.h>
+#include <maths/vector4.h>
+#include <maths/plane.h>
+#include <maths/aabb.h>
+
+// Matrix44 is 4 rows of 4 floats with no padding and Vector4 is 4 floats, so both are read and written as float arrays here.
+// Matrix44 and Vector4 are only 4 byte aligned, so unaligned loads and stores are used.
+// On aligned data they are as fast as the aligned versions.
+
+#define GEF_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define GEF_SWIZZLE(vec, x, y, z, w) _mm_shuffle_ps(vec, vec, GEF_SHUFFLE_MASK(x, y, z, w))
+#define GEF_SPLAT(vec, i) _mm_shuffle_ps(vec, vec, GEF_SHUFFLE_MASK(i, i, i, i))
+
+namespace gef
+{
+	namespace simd
+	{
+		// 2x2 matrix product a * b, each matrix stored in one register as (m00, m01, m10, m11)
+		static inline __m128 Mat2Mul(__m128 a, __m128 b)
+		{
+			return _mm_add_ps(_mm_mul_ps(a, GEF_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(GEF_SWIZZLE(a, 1, 0, 3, 2), GEF_SWIZZLE(b, 2, 1, 2, 1)));
+		}
+
+		// 2x2 matrix product adjugate(a) * b
+		static inline __m128 Mat2AdjMul(__m128 a, __m128 b)
+		{
+			return _mm_sub_ps(_mm_mul_ps(GEF_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(GEF_SWIZZLE(a, 1, 1, 2, 2), GEF_SWIZZLE(b, 2, 3, 0, 1)));
+		}
+
+		// 2x2 matrix product a * adjugate(b)
+		static inline __m128 Mat2MulAdj(__m128 a, __m128 b)
+		{
+			return _mm_sub_ps(_mm_mul_ps(a, GEF_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(GEF_SWIZZLE(a, 1, 0, 3, 2), GEF_SWIZZLE(b, 2, 1, 2, 1)));
+		}
+
+		void MatrixMultiply(Matrix44& result, const Matrix44& left, const Matrix44& right)
+		{
+			const float* left_values = left.float_ptr();
+			float* result_values = (float*)&result;
+
+			// load all of the right hand matrix first so it can also be the result
+			const __m128 right_row0 = _mm_loadu_ps(right.float_ptr());
+			const __m128 right_row1 = _mm_loadu_ps(right.float_ptr() + 4);
+			const __m128 right_row2 = _mm_loadu_ps(right.float_ptr() + 8);
+			const __m128 right_row3 = _mm_loadu_ps(right.float_ptr() + 12);
+
+			for (int i = 0; i < 4; i++)
+			{
+				// each row of the result is the sum of the right hand rows scaled by the left hand row's elements
+				__m128 row = _mm_loadu_ps(left_values + i * 4);
+				__m128 product = _mm_mul_ps(GEF_SPLAT(row, 0), right_row0);
+				product = _mm_add_ps(product, _mm_mul_ps(GEF_SPLAT(row, 1), right_row1));
+				product = _mm_add_ps(product, _mm_mul_ps(GEF_SPLAT(row, 2), right_row2));
+				product = _mm_add_ps(product, _mm_mul_ps(GEF_SPLAT(row, 3), right_row3));
+				_mm_storeu_ps(result_values + i * 4, product);
+			}
+		}
+
+		void MatrixInverse(Matrix44& result, const Matrix44& matrix, float* determinant)
+		{
+			// block matrix inverse, splitting the matrix into four 2x2 sub matrices
+			// | A B |
+			// | C D |
+			const __m128 row0 = _mm_loadu_ps(matrix.float_ptr());
+			const __m128 row1 = _mm_loadu_ps(matrix.float_ptr() + 4);
+			const __m128 row2 = _mm_loadu_ps(matrix.float_ptr() + 8);
+			const __m128 row3 = _mm_loadu_ps(matrix.float_ptr() + 12);
+
+			const __m128 a = _mm_movelh_ps(row0, row1);
+			const __m128 b = _mm_movehl_ps(row1, row0);
+			const __m128 c = _mm_movelh_ps(row2, row3);
+			const __m128 d = _mm_movehl_ps(row3, row2);
+
+			// determinants of the sub matrices as (|A|, |B|, |C|, |D|)
+			const __m128 det_sub = _mm_sub_ps(
+				_mm_mul_ps(_mm_shuffle_ps(row0, row2, GEF_SHUFFLE_MASK(0, 2, 0, 2)), _mm_shuffle_ps(row1, row3, GEF_SHUFFLE_MASK(1, 3, 1, 3))),
+				_mm_mul_ps(_mm_shuffle_ps(row0, row2, GEF_SHUFFLE_MASK(1, 3, 1, 3)), _mm_shuffle_ps(row1, row3, GEF_SHUFFLE_MASK(0, 2, 0, 2))));
+			const __m128 det_a = GEF_SPLAT(det_sub, 0);
+			const __m128 det_b = GEF_SPLAT(det_sub, 1);
+			const __m128 det_c = GEF_SPLAT(det_sub, 2);
+			const __m128 det_d = GEF_SPLAT(det_sub, 3);
+
+			const __m128 d_c = Mat2AdjMul(d, c);
+			const __m128 a_b = Mat2AdjMul(a, b);
+
+			// adjugates of the four blocks of the inverse
+			__m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), Mat2Mul(b, d_c));
+			__m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), Mat2Mul(c, a_b));
+			__m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), Mat2MulAdj(d, a_b));
+			__m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), Mat2MulAdj(a, d_c));
+
+			// |M| = |A||D| + |B||C| - trace((A#B)(D#C))
+			__m128 trace = _mm_mul_ps(a_b, GEF_SWIZZLE(d_c, 0, 2, 1, 3));
+			trace = _mm_add_ps(trace, _mm_movehl_ps(trace, trace));
+			trace = _mm_add_ss(trace, GEF_SPLAT(trace, 1));
+			__m128 det = _mm_add_ss(_mm_mul_ss(det_a, det_d), _mm_mul_ss(det_b, det_c));
+			det = _mm_sub_ss(det, trace);
+
+			const float det_value = _mm_cvtss_f32(det);
+			if (det_value != 0.0f)
+			{
+				// (1/|M|, -1/|M|, -1/|M|, 1/|M|), the signs complete the adjugates
+				const __m128 reciprocal_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), GEF_SPLAT(det, 0));
+				x = _mm_mul_ps(x, reciprocal_det);
+				y = _mm_mul_ps(y, reciprocal_det);
+				z = _mm_mul_ps(z, reciprocal_det);
+				w = _mm_mul_ps(w, reciprocal_det);
+
+				// the shuffles swap the diagonal of each adjugate and put the blocks back into rows
+				float* result_values = (float*)&result;
+				_mm_storeu_ps(result_values, _mm_shuffle_ps(x, y, GEF_SHUFFLE_MASK(3, 1, 3, 1)));
+				_mm_storeu_ps(result_values + 4, _mm_shuffle_ps(x, y, GEF_SHUFFLE_MASK(2, 0, 2, 0)));
+				_mm_storeu_ps(result_values + 8, _mm_shuffle_ps(z, w, GEF_SHUFFLE_MASK(3, 1, 3, 1)));
+				_mm_storeu_ps(result_values + 12, _mm_shuffle_ps(z, w, GEF_SHUFFLE_MASK(2, 0, 2, 0)));
+			}
+
+			if (determinant)
+				*determinant = det_value;
+		}
+
+		void TransformPoints(const Matrix44& matrix, const Vector4* points, Vector4* results, Int32 num_points)
+		{
+			const __m128 row0 = _mm_loadu_ps(matrix.float_ptr());
+			const __m128 row1 = _mm_loadu_ps(matrix.float_ptr() + 4);
+			const __m128 row2 = _mm_loadu_ps(matrix.float_ptr() + 8);
+			const __m128 row3 = _mm_loadu_ps(matrix.float_ptr() + 12);
+
+			for (Int32 point_num = 0; point_num < num_points; ++point_num)
+			{
+				__m128 point = _mm_loadu_ps(points[point_num].float_ptr());
+				__m128 result = _mm_mul_ps(GEF_SPLAT(point, 0), row0);
+				result = _mm_add_ps(result, _mm_mul_ps(GEF_SPLAT(point, 1), row1));
+				result = _mm_add_ps(result, _mm_mul_ps(GEF_SPLAT(point, 2), row2));
+				result = _mm_add_ps(result, row3);
+				_mm_storeu_ps((float*)&results[point_num], result);
+			}
+		}
+
+		void FrustumIntersects(const Plane* planes, const Aabb* aabbs, FrustumIntersect* results, Int32 num_aabbs)
+		{
+			const __m128 half = _mm_set1_ps(0.5f);
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 sign_mask = _mm_set1_ps(-0.0f);
+
+			// test four boxes at a time, with one box in each lane
+			Int32 aabb_num = 0;
+			for (; aabb_num + 4 <= num_aabbs; aabb_num += 4)
+			{
+				const Aabb* box = &aabbs[aabb_num];
+
+				// transpose the bounds so each register holds one axis of all four boxes
+				__m128 min_x = _mm_loadu_ps(box[0].min_vtx().float_ptr());
+				__m128 min_y = _mm_loadu_ps(box[1].min_vtx().float_ptr());
+				__m128 min_z = _mm_loadu_ps(box[2].min_vtx().float_ptr());
+				__m128 min_w = _mm_loadu_ps(box[3].min_vtx().float_ptr());
+				_MM_TRANSPOSE4_PS(min_x, min_y, min_z, min_w);
+
+				__m128 max_x = _mm_loadu_ps(box[0].max_vtx().float_ptr());
+				__m128 max_y = _mm_loadu_ps(box[1].max_vtx().float_ptr());
+				__m128 max_z = _mm_loadu_ps(box[2].max_vtx().float_ptr());
+				__m128 max_w = _mm_loadu_ps(box[3].max_vtx().float_ptr());
+				_MM_TRANSPOSE4_PS(max_x, max_y, max_z, max_w);
+
+				const __m128 centre_x = _mm_mul_ps(_mm_add_ps(min_x, max_x), half);
+				const __m128 centre_y = _mm_mul_ps(_mm_add_ps(min_y, max_y), half);
+				const __m128 centre_z = _mm_mul_ps(_mm_add_ps(min_z, max_z), half);
+				const __m128 extent_x = _mm_mul_ps(_mm_sub_ps(max_x, min_x), half);
+				const __m128 extent_y = _mm_mul_ps(_mm_sub_ps(max_y, min_y), half);
+				const __m128 extent_z = _mm_mul_ps(_mm_sub_ps(max_z, min_z), half);
+
+				__m128 out = zero;
+				__m128 intersects = zero;
+				for (int p = 0; p < NUM_FRUSTUM_PLANES; ++p)
+				{
+					const __m128 plane = _mm_loadu_ps(planes[p].float_ptr());
+					const __m128 abs_plane = _mm_andnot_ps(sign_mask, plane);
+
+					__m128 distance = _mm_mul_ps(GEF_SPLAT(plane, 0), centre_x);
+					distance = _mm_add_ps(distance, _mm_mul_ps(GEF_SPLAT(plane, 1), centre_y));
+					distance = _mm_add_ps(distance, _mm_mul_ps(GEF_SPLAT(plane, 2), centre_z));
+					distance = _mm_add_ps(distance, GEF_SPLAT(plane, 3));
+
+					__m128 radius = _mm_mul_ps(GEF_SPLAT(abs_plane, 0), extent_x);
+					radius = _mm_add_ps(radius, _mm_mul_ps(GEF_SPLAT(abs_plane, 1), extent_y));
+					radius = _mm_add_ps(radius, _mm_mul_ps(GEF_SPLAT(abs_plane, 2), extent_z));
+
+					out = _mm_or_ps(out, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+					intersects = _mm_or_ps(intersects, _mm_cmplt_ps(_mm_sub_ps(distance, radius), zero));
+				}
+
+				const int out_bits = _mm_movemask_ps(out);
+				const int intersects_bits = _mm_movemask_ps(intersects);
+				for (int lane = 0; lane < 4; ++lane)
+				{
+					if (out_bits & (1 << lane))
+						results[aabb_num + lane] = FI_OUT;
+					else if (intersects_bits & (1 << lane))
+						results[aabb_num + lane] = FI_INTERSECTS;
+					else
+						results[aabb_num + lane] = FI_IN;
+				}
+			}
+
+			// any boxes left over don't fill a register
+			scalar::FrustumIntersects(planes, &aabbs[aabb_num], &results[aabb_num], num_aabbs - aabb_num);
+		}
+	}
+}
+
+#endif // GEF_SIMD_SSE
@@ -2,6 +2,7 @@
 #include <maths/vector4.h>
 #include <maths/vector4.h>
 #include <maths/quaternion.h>
+#include <maths/maths_kernels.h>
 #include <math.h>
 
 
@@ -36,18 +37,15 @@ namespace gef
 	const Matrix44 Matrix44::operator*(const Matrix44& matrix) const
 	{
 		Matrix44 result;
-
-		for (int i = 0; i < 4; i++)
-		{
-			result.values_[i].set_x(values_[i].x() * matrix.values_[0].x() + values_[i].y() * matrix.values_[1].x() + values_[i].z() * matrix.values_[2].x() + values_[i].w() * matrix.values_[3].x());
-			result.values_[i].set_y(values_[i].x() * matrix.values_[0].y() + values_[i].y() * matrix.values_[1].y() + values_[i].z() * matrix.values_[2].y() + values_[i].w() * matrix.values_[3].y());
-			result.values_[i].set_z(values_[i].x() * matrix.values_[0].z() + values_[i].y() * matrix.values_[1].z() + values_[i].z() * matrix.values_[2].z() + values_[i].w() * matrix.values_[3].z());
-			result.values_[i].set_w(values_[i].x() * matrix.values_[0].w() + values_[i].y() * matrix.values_[1].w() + values_[i].z() * matrix.values_[2].w() + values_[i].w() * matrix.values_[3].w());
-		}
-
+		kernels::MatrixMultiply(result, *this, matrix);
 		return result; 
 	}
 
+	void Matrix44::TransformPoints(const Vector4* points, Vector4* results, Int32 num_points) const
+	{
+		kernels::TransformPoints(*this, points, results, num_points);
+	}
+
 	void Matrix44::LookAt(const Vector4& eye, const Vector4& lookat, const Vector4& up)
 	{
 		SetIdentity();
@@ -353,36 +351,6 @@ namespace gef
 
 	void Matrix44::Inverse(const Matrix44 matrix, float* determinant)
 	{
-		int a, i, j;
-		Vector4 v, vec[3];
-		float det;
-
-		det = matrix.CalculateDeterminant();
-		if ( det!= 0.0f )
-		{
-			for (i=0; i<4; i++)
-			{
-				for (j=0; j<4; j++)
-				{
-					if (j != i )
-					{
-						a = j;
-						if ( j > i )
-							a = a-1;
-
-						vec[a] = matrix.GetRow(j);
-					}
-				}
-
-				v = vec[0].CrossProduct3(vec[1], vec[2]);
-
-
-				float temp = powf(-1.0f, (float)i) / det;
-				SetColumn(i, Vector4(temp*v.x(), temp*v.y(), temp*v.z(), temp*v.w()));
-			}
-	   }
-
-		if(determinant)
-			*determinant = det;
+		kernels::MatrixInverse(*this, matrix, determinant);
 	}
 }
\ No newline at end of file
@@ -155,6 +155,12 @@ namespace gef
 		/// @return The result of the operation.
 		const Matrix44 operator*(const Matrix44& matrix) const;
 
+		/// @brief Transform an array of points by this matrix.
+		/// @param[in] points		The points to be transformed. The w component is ignored and treated as 1.
+		/// @param[out] results		The transformed points, including the w component. Can be the same array as points.
+		/// @param[in] num_points	The number of points in the arrays.
+		void TransformPoints(const Vector4* points, Vector4* results, Int32 num_points) const;
+
 		/// @brief Get a particular row from this matrix.
 		/// @param[in] row		The row number.
 		/// @return The contents of selected row.
@@ -207,7 +213,7 @@ namespace gef
 			*(((float*)&values_[row]) + column) = value;
 		}
 
-		inline const float* float_ptr() { return values_[0].float_ptr(); }
+		inline const float* float_ptr() const { return values_[0].float_ptr(); }
 
 	protected:
 		/// The matrix is stored as 4 rows of Vectors
@@ -0,0 +1,12 @@
+#ifndef _GEF_MATHS_SIMD_H
+#define _GEF_MATHS_SIMD_H
+
+// GEF_SIMD_SSE is defined when the maths library is built with the SSE2 code paths.
+// SSE2 is always available on x64 and is the default instruction set for x86 builds.
+// Define GEF_NO_SIMD in the project settings to force the scalar code paths on every platform.
+#if !defined(GEF_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define GEF_SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+#endif // _GEF_MATHS_SIMD_H
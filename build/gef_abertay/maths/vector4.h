@@ -38,7 +38,7 @@ public:
 	const Vector4 TransformW(const class Matrix44& _mat) const;
 	const Vector4 CrossProduct3(const Vector4& v2, const Vector4& v3) const;
 
-	const float* float_ptr() { return &values_[0]; }
+	const float* float_ptr() const { return &values_[0]; }
 
 
 	float x() const;
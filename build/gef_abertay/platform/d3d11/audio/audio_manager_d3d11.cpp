@@ -36,16 +36,6 @@ namespace gef
 					// Create new sound buffer and load in the data
 					sf::SoundBuffer* newBuffer = new sf::SoundBuffer();
 					if (newBuffer->loadFromMemory(rawSample, bytesRead)) {
-						// Add the new buffer to the vector
-						sampleBuffers_.push_back(newBuffer);
-
-						// Create a new sound and assign it the buffer
-						sf::Sound* newSound = new sf::Sound();
-						newSound->setBuffer(*newBuffer);
-
-						// Add new sound to the samples
-						samples_.push_back(newSound);
-
 						// Delete the old raw data
 						delete[] rawSample;
 
@@ -54,8 +44,9 @@ namespace gef
 						delete sampleFile;
 
 						// Return the index of the new sounds
-						return (int)(samples_.size() - 1);
+						return AddSoundBuffer(newBuffer);
 					}
+					delete newBuffer;
 				}
 				delete[] rawSample;
 			}
@@ -66,6 +57,86 @@ namespace gef
 		return -1;
 	}
 
+	// Sample data decoded to 16 bit PCM, ready to be copied into a sound buffer
+	class DecodedSampleD3D11 : public DecodedSample
+	{
+	public:
+		DecodedSampleD3D11(const char* filename) :
+			DecodedSample(filename),
+			channelCount(0),
+			sampleRate(0)
+		{
+		}
+
+		std::vector<sf::Int16> samples;
+		unsigned int channelCount;
+		unsigned int sampleRate;
+	};
+
+	DecodedSample* AudioManagerD3D11::DecodeSample(const char * strFileName, const Platform & platform)
+	{
+		// Read the whole sound file into memory
+		DecodedSampleD3D11* decoded = NULL;
+		File* sampleFile = File::Create();
+		if (sampleFile->Open(strFileName)) {
+			Int32 fileSize;
+			if (sampleFile->GetSize(fileSize)) {
+				UInt8* rawSample = new UInt8[fileSize];
+				Int32 bytesRead = 0;
+				if (sampleFile->Read(rawSample, fileSize, bytesRead)) {
+					// Decode all of it, this doesn't touch the audio device so it can be done on any thread
+					sf::InputSoundFile soundFile;
+					if (soundFile.openFromMemory(rawSample, bytesRead)) {
+						decoded = new DecodedSampleD3D11(strFileName);
+						decoded->samples.resize((size_t)soundFile.getSampleCount());
+						decoded->channelCount = soundFile.getChannelCount();
+						decoded->sampleRate = soundFile.getSampleRate();
+						if (!decoded->samples.empty())
+							decoded->samples.resize((size_t)soundFile.read(&decoded->samples[0], decoded->samples.size()));
+					}
+				}
+				delete[] rawSample;
+			}
+			sampleFile->Close();
+		}
+
+		delete sampleFile;
+		return decoded;
+	}
+
+	Int32 AudioManagerD3D11::AddSample(DecodedSample * sample, const Platform & platform)
+	{
+		DecodedSampleD3D11* decoded = static_cast<DecodedSampleD3D11*>(sample);
+		Int32 sampleIndex = -1;
+		if (decoded && !decoded->samples.empty()) {
+			// Copy the decoded data into a new sound buffer
+			sf::SoundBuffer* newBuffer = new sf::SoundBuffer();
+			if (newBuffer->loadFromSamples(&decoded->samples[0], decoded->samples.size(), decoded->channelCount, decoded->sampleRate))
+				sampleIndex = AddSoundBuffer(newBuffer);
+			else
+				delete newBuffer;
+		}
+
+		delete sample;
+		return sampleIndex;
+	}
+
+	Int32 AudioManagerD3D11::AddSoundBuffer(sf::SoundBuffer * buffer)
+	{
+		// Add the new buffer to the vector
+		sampleBuffers_.push_back(buffer);
+
+		// Create a new sound and assign it the buffer
+		sf::Sound* newSound = new sf::Sound();
+		newSound->setBuffer(*buffer);
+
+		// Add new sound to the samples
+		samples_.push_back(newSound);
+
+		// Return the index of the new sound
+		return (int)(samples_.size() - 1);
+	}
+
 	Int32 AudioManagerD3D11::LoadMusic(const char * strFileName, const Platform & platform)
 	{
 		// If the music already has been loaded, unload it so it can be replaced
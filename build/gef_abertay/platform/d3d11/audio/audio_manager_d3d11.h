@@ -41,7 +41,12 @@ public:
 	bool sample_voice_playing(const UInt32 voice_index);
 	bool sample_voice_looping(const UInt32 voice_index);
 
+	DecodedSample* DecodeSample(const char *strFileName, const Platform& platform);
+	Int32 AddSample(DecodedSample* sample, const Platform& platform);
+
 private:
+	Int32 AddSoundBuffer(sf::SoundBuffer* buffer);
+
 	std::vector<UInt8*> rawSampleData_;
 	std::vector<sf::SoundBuffer*> sampleBuffers_;
 	std::vector<sf::Sound*> samples_;
@@ -8,6 +8,7 @@
 */
 
 #include <platform/d3d11/system/platform_d3d11.h>
+#include <system/profiler.h>
 #include <graphics/mesh_instance.h>
 //#include <graphics/gl/shader_gl.h>
 #include <graphics/mesh.h>
@@ -43,9 +44,12 @@ namespace gef
 		,default_blend_state_(NULL)
 		,default_depth_stencil_state_(NULL)
 		,always_depth_stencil_state_(NULL)
+		,instanced_shader_(platform)
+		,instance_buffer_(NULL)
 
 	{
 		platform_.AddShader(&default_shader_);
+		platform_.AddShader(&instanced_shader_);
 		shader_ = &default_shader_;
 
 		projection_matrix_.SetIdentity();
@@ -123,6 +127,19 @@ namespace gef
 			platform_d3d.device()->CreateDepthStencilState(&dsDesc, &always_depth_stencil_state_);
 		}
 
+		if (SUCCEEDED(hresult))
+		{
+			// per instance world matrices, rewritten for every instanced draw
+			D3D11_BUFFER_DESC instance_buffer_desc;
+			ZeroMemory(&instance_buffer_desc, sizeof(D3D11_BUFFER_DESC));
+			instance_buffer_desc.Usage = D3D11_USAGE_DYNAMIC;
+			instance_buffer_desc.ByteWidth = sizeof(Matrix44) * kMaxInstancesPerDraw;
+			instance_buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+			instance_buffer_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+			hresult = platform_d3d.device()->CreateBuffer(&instance_buffer_desc, NULL, &instance_buffer_);
+		}
+
 
 		if (FAILED(hresult))
 		{
@@ -142,8 +159,10 @@ namespace gef
 		ReleaseNull(default_blend_state_);
 		ReleaseNull(default_depth_stencil_state_);
 		ReleaseNull(always_depth_stencil_state_);
+		ReleaseNull(instance_buffer_);
 
 		platform_.RemoveShader(&default_shader_);
+		platform_.RemoveShader(&instanced_shader_);
 
 	}
 
@@ -151,6 +170,9 @@ namespace gef
 	// and use only variables to clear render_target, depth_duffer and stencil_buffer separately
 	void Renderer3DD3D11::Begin(bool clear)
 	{
+		GEF_PROFILE_ZONE("Renderer3D::Begin");
+		ResetFrame();
+
 		const PlatformD3D11& platform_d3d = static_cast<const PlatformD3D11&>(platform());
 		platform_d3d.BeginScene();
 
@@ -164,6 +186,9 @@ namespace gef
 
 	void Renderer3DD3D11::End()
 	{
+		GEF_PROFILE_ZONE("Renderer3D::End");
+		FlushSubmittedMeshes();
+
 		const PlatformD3D11& platform_d3d = static_cast<const PlatformD3D11&>(platform());
 		platform_d3d.EndScene();
 
@@ -192,6 +217,8 @@ namespace gef
 
 				shader_->device_interface()->UseProgram();
 				vertex_buffer->Bind(platform_);
+				stats_.state_changes++;
+				stats_.instances++;
 
 				// vertex format must be set after the vertex buffer is bound
 				shader_->device_interface()->SetVertexFormat();
@@ -212,6 +239,7 @@ namespace gef
 
 						//only set default shader data if current shader is the default shader
 						shader_->SetMaterialData(material);
+						stats_.state_changes++;
 
 						// GRC FIXME - probably want to split variable data into scene, object, primitive[material?] based
 						// rather than set all variables per primitive
@@ -233,6 +261,7 @@ namespace gef
 							platform_d3d.device_context()->DrawIndexed(index_buffer->num_indices(), 0, 0);
 						else
 							platform_d3d.device_context()->Draw(vertex_buffer->num_vertices(), 0);
+						stats_.draw_calls++;
 
 
 						index_buffer->Unbind(platform_);
@@ -264,6 +293,8 @@ namespace gef
 
 				shader_->device_interface()->UseProgram();
 				vertex_buffer->Bind(platform_);
+				stats_.state_changes++;
+				stats_.instances++;
 
 				// vertex format must be set after the vertex buffer is bound
 				shader_->device_interface()->SetVertexFormat();
@@ -284,6 +315,7 @@ namespace gef
 
 						//only set default shader data if current shader is the default shader
 						shader_->SetMaterialData(material);
+						stats_.state_changes++;
 
 						// GRC FIXME - probably want to split variable data into scene, object, primitive[material?] based
 						// rather than set all variables per primitive
@@ -357,6 +389,82 @@ namespace gef
 			platform_d3d.device_context()->DrawIndexed(num_indices, 0, 0);
 		else
 			platform_d3d.device_context()->Draw(num_indices, 0);
+		stats_.draw_calls++;
+	}
+
+	void Renderer3DD3D11::DrawMeshInstances(const Mesh& mesh, const Material* material, const gef::Matrix44* matrices, Int32 num_instances)
+	{
+		// the instanced shader only replaces the default shader, custom shaders draw one instance at a time
+		const VertexBuffer* vertex_buffer = mesh.vertex_buffer();
+		if (shader_ != &default_shader_ || !instance_buffer_ || !instanced_shader_.device_interface())
+		{
+			Renderer3D::DrawMeshInstances(mesh, material, matrices, num_instances);
+			return;
+		}
+
+		if (!vertex_buffer)
+			return;
+
+		const PlatformD3D11& platform_d3d = static_cast<const PlatformD3D11&>(platform_);
+		ShaderInterface* device_interface = instanced_shader_.device_interface();
+
+		instanced_shader_.SetSceneData(default_shader_data_, view_matrix_, projection_matrix_);
+
+		device_interface->UseProgram();
+		vertex_buffer->Bind(platform_);
+		stats_.state_changes++;
+
+		// bind the instance matrices as the second vertex stream
+		UINT instance_stride = sizeof(Matrix44);
+		UINT instance_offset = 0;
+		platform_d3d.device_context()->IASetVertexBuffers(1, 1, &instance_buffer_, &instance_stride, &instance_offset);
+
+		// vertex format must be set after the vertex buffers are bound
+		device_interface->SetVertexFormat();
+
+		// Renderer3D splits groups so they always fit the instance buffer
+		D3D11_MAPPED_SUBRESOURCE mapped_resource;
+		HRESULT hresult = platform_d3d.device_context()->Map(instance_buffer_, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_resource);
+		if (SUCCEEDED(hresult))
+		{
+			memcpy(mapped_resource.pData, matrices, sizeof(Matrix44) * num_instances);
+			platform_d3d.device_context()->Unmap(instance_buffer_, 0);
+
+			for (UInt32 primitive_index = 0; primitive_index < mesh.num_primitives(); ++primitive_index)
+			{
+				const Primitive* primitive = mesh.GetPrimitive(primitive_index);
+				const IndexBuffer* index_buffer = primitive->index_buffer();
+				if (primitive->type() != UNDEFINED && index_buffer)
+				{
+					instanced_shader_.SetMaterialData(material ? material : primitive->material());
+					stats_.state_changes++;
+
+					device_interface->SetVariableData();
+					device_interface->BindTextureResources(platform());
+
+					SetPrimitiveType(primitive->type());
+
+					index_buffer->Bind(platform_);
+					if (index_buffer->num_indices() > 0)
+						platform_d3d.device_context()->DrawIndexedInstanced(index_buffer->num_indices(), num_instances, 0, 0, 0);
+					else
+						platform_d3d.device_context()->DrawInstanced(vertex_buffer->num_vertices(), num_instances, 0, 0);
+					stats_.draw_calls++;
+					index_buffer->Unbind(platform_);
+
+					device_interface->UnbindTextureResources(platform());
+				}
+			}
+		}
+		stats_.instances += num_instances;
+
+		// unbind the instance stream so later non-instanced draws only see the mesh's vertex buffer
+		ID3D11Buffer* null_buffer = NULL;
+		UINT null_stride = 0;
+		platform_d3d.device_context()->IASetVertexBuffers(1, 1, &null_buffer, &null_stride, &instance_offset);
+
+		device_interface->ClearVertexFormat();
+		vertex_buffer->Unbind(platform_);
 	}
 
 }
@@ -13,6 +13,7 @@
 #include <graphics/renderer_3d.h>
 //#include <graphics/primitive.h>
 #include <graphics/default_3d_shader.h>
+#include <graphics/default_3d_instanced_shader.h>
 
 namespace gef
 {
@@ -41,6 +42,8 @@ namespace gef
 	protected:
 		static const D3D11_PRIMITIVE_TOPOLOGY Renderer3DD3D11::primitive_types[NUM_PRIMITIVE_TYPES];
 
+		void DrawMeshInstances(const Mesh& mesh, const Material* material, const gef::Matrix44* matrices, Int32 num_instances);
+
 	private:
 		ID3D11RasterizerState* default_render_state_;
 		ID3D11RasterizerState* wireframe_render_state_;
@@ -48,6 +51,9 @@ namespace gef
 
 		ID3D11DepthStencilState* default_depth_stencil_state_;
 		ID3D11DepthStencilState* always_depth_stencil_state_;
+
+		Default3DInstancedShader instanced_shader_;
+		ID3D11Buffer* instance_buffer_;
 	};
 }
 
@@ -249,11 +249,22 @@ namespace gef
 		element.SemanticName = shader_parameter.semantic_name.c_str();
 		element.SemanticIndex = shader_parameter.semantic_index;
 		element.Format = GetVertexAttributeFormat(shader_parameter.type);
-		element.InputSlot = 0;
 //		element.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
 		element.AlignedByteOffset = shader_parameter.byte_offset;
-		element.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-		element.InstanceDataStepRate = 0;
+
+		// per instance parameters are read from a second vertex buffer, advancing once per instance
+		if (shader_parameter.per_instance)
+		{
+			element.InputSlot = 1;
+			element.InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+			element.InstanceDataStepRate = 1;
+		}
+		else
+		{
+			element.InputSlot = 0;
+			element.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+			element.InstanceDataStepRate = 0;
+		}
 	}
 
 	DXGI_FORMAT ShaderInterfaceD3D11::GetVertexAttributeFormat(VariableType type)
@@ -352,6 +363,29 @@ namespace gef
 		}
 	}
 
+	void ShaderInterfaceD3D11::AddSamplerState(SamplerAddressMode address_mode)
+	{
+		D3D11_TEXTURE_ADDRESS_MODE d3d_address_mode = address_mode == kClamp ? D3D11_TEXTURE_ADDRESS_CLAMP : D3D11_TEXTURE_ADDRESS_WRAP;
+
+		// Create a texture sampler state description.
+		D3D11_SAMPLER_DESC sampler_desc;
+		sampler_desc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+		sampler_desc.AddressU = d3d_address_mode;
+		sampler_desc.AddressV = d3d_address_mode;
+		sampler_desc.AddressW = d3d_address_mode;
+		sampler_desc.MipLODBias = 0.0f;
+		sampler_desc.MaxAnisotropy = 1;
+		sampler_desc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+		sampler_desc.BorderColor[0] = 0;
+		sampler_desc.BorderColor[1] = 0;
+		sampler_desc.BorderColor[2] = 0;
+		sampler_desc.BorderColor[3] = 0;
+		sampler_desc.MinLOD = 0;
+		sampler_desc.MaxLOD = D3D11_FLOAT32_MAX;
+
+		AddSamplerState(sampler_desc);
+	}
+
 	void ShaderInterfaceD3D11::AddSamplerState(const D3D11_SAMPLER_DESC& sampler_desc)
 	{
 		// Create the texture sampler state.
@@ -24,6 +24,7 @@ namespace gef
 		void BindTextureResources(const Platform& platform) const;
 		void UnbindTextureResources(const Platform& platform) const;
 
+		void AddSamplerState(SamplerAddressMode address_mode);
 		void AddSamplerState(const D3D11_SAMPLER_DESC& sampler_desc);
 
 	protected:
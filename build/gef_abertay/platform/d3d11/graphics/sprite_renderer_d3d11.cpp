@@ -6,6 +6,7 @@
 #include <graphics/vertex_buffer.h>
 #include <graphics/sprite.h>
 #include <graphics/shader_interface.h>
+#include <system/profiler.h>
 
 namespace gef
 {
@@ -122,6 +123,7 @@ namespace gef
 
 	void SpriteRendererD3D11::Begin(bool clear)
 	{
+		GEF_PROFILE_ZONE("SpriteRenderer::Begin");
 		platform_.BeginScene();
 		if(clear)
 			platform_.Clear();
@@ -173,6 +175,7 @@ namespace gef
 
 	void SpriteRendererD3D11::End()
 	{
+		GEF_PROFILE_ZONE("SpriteRenderer::End");
 		vertex_buffer_->Unbind(platform_);
 
 		platform_.EndScene();
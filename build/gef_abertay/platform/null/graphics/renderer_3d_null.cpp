@@ -0,0 +1,89 @@
+#include <platform/null/graphics/renderer_3d_null.h>
+#include <graphics/mesh_instance.h>
+#include <graphics/mesh.h>
+#include <graphics/primitive.h>
+#include <graphics/vertex_buffer.h>
+#include <system/profiler.h>
+
+namespace gef
+{
+	Renderer3D* Renderer3D::Create(Platform& platform)
+	{
+		return new Renderer3DNull(platform);
+	}
+
+	Renderer3DNull::Renderer3DNull(Platform& platform) :
+		Renderer3D(platform)
+	{
+		shader_ = &default_shader_;
+	}
+
+	Renderer3DNull::~Renderer3DNull()
+	{
+	}
+
+	void Renderer3DNull::Begin(bool clear)
+	{
+		GEF_PROFILE_ZONE("Renderer3D::Begin");
+		ResetFrame();
+	}
+
+	void Renderer3DNull::End()
+	{
+		GEF_PROFILE_ZONE("Renderer3D::End");
+		FlushSubmittedMeshes();
+	}
+
+	void Renderer3DNull::DrawMesh(const MeshInstance& mesh_instance)
+	{
+		if (mesh_instance.mesh())
+			CountMesh(*mesh_instance.mesh(), 1);
+	}
+
+	void Renderer3DNull::DrawMesh(const Mesh& mesh, const gef::Matrix44& matrix)
+	{
+		CountMesh(mesh, 1);
+	}
+
+	void Renderer3DNull::DrawMeshInstances(const Mesh& mesh, const Material* material, const gef::Matrix44* matrices, Int32 num_instances)
+	{
+		// Renderer3D has already split the group, so every instance goes in a single draw per primitive
+		CountMesh(mesh, num_instances);
+	}
+
+	void Renderer3DNull::CountMesh(const Mesh& mesh, Int32 num_instances)
+	{
+		if (!mesh.vertex_buffer() || !shader_)
+			return;
+
+		// one vertex buffer bind, then a material change and a draw for each drawable primitive
+		stats_.state_changes++;
+		for (UInt32 primitive_index = 0; primitive_index < mesh.num_primitives(); ++primitive_index)
+		{
+			const Primitive* primitive = mesh.GetPrimitive(primitive_index);
+			if (primitive->type() != UNDEFINED && primitive->index_buffer())
+			{
+				stats_.state_changes++;
+				stats_.draw_calls++;
+			}
+		}
+		stats_.instances += num_instances;
+	}
+
+	void Renderer3DNull::SetFillMode(FillMode fill_mode)
+	{
+	}
+
+	void Renderer3DNull::SetDepthTest(DepthTest depth_test)
+	{
+	}
+
+	void Renderer3DNull::SetPrimitiveType(gef::PrimitiveType type)
+	{
+	}
+
+	void Renderer3DNull::DrawPrimitive(const IndexBuffer* index_buffer, int num_indices)
+	{
+		stats_.draw_calls++;
+	}
+}
@@ -0,0 +1,35 @@
+#ifndef _GEF_RENDERER_3D_NULL_H
+#define _GEF_RENDERER_3D_NULL_H
+
+#include <graphics/renderer_3d.h>
+
+namespace gef
+{
+	/**
+	Renderer3D which draws nothing, but counts the draw calls and state changes a real device would receive.
+	The counts follow the D3D11 renderer.
+	*/
+	class Renderer3DNull : public Renderer3D
+	{
+	public:
+		Renderer3DNull(Platform& platform);
+		~Renderer3DNull();
+
+		void Begin(bool clear = true);
+		void End();
+
+		void DrawMesh(const MeshInstance& mesh_instance);
+		void DrawMesh(const Mesh& mesh, const gef::Matrix44& matrix);
+		void SetFillMode(FillMode fill_mode);
+		void SetDepthTest(DepthTest depth_test);
+		void SetPrimitiveType(gef::PrimitiveType type);
+		void DrawPrimitive(const IndexBuffer* index_buffer, int num_indices);
+
+	protected:
+		void DrawMeshInstances(const Mesh& mesh, const Material* material, const gef::Matrix44* matrices, Int32 num_instances);
+
+		void CountMesh(const Mesh& mesh, Int32 num_instances);
+	};
+}
+
+#endif // _GEF_RENDERER_3D_NULL_H
@@ -0,0 +1,28 @@
+#ifndef _GEF_SHADER_INTERFACE_NULL_H
+#define _GEF_SHADER_INTERFACE_NULL_H
+
+#include <graphics/shader_interface.h>
+
+namespace gef
+{
+	class ShaderInterfaceNull : public ShaderInterface
+	{
+	public:
+		ShaderInterfaceNull();
+		~ShaderInterfaceNull();
+
+		bool CreateProgram();
+		void CreateVertexFormat();
+
+		void UseProgram();
+
+		void SetVariableData();
+		void SetVertexFormat();
+		void ClearVertexFormat();
+
+		void BindTextureResources(const Platform& platform) const;
+		void UnbindTextureResources(const Platform& platform) const;
+	};
+}
+
+#endif // _GEF_SHADER_INTERFACE_NULL_H
@@ -0,0 +1,10 @@
+#include <graphics/sprite_renderer.h>
+#include <cstddef> // for NULL definition
+
+namespace gef
+{
+	SpriteRenderer* SpriteRenderer::Create(Platform& platform)
+	{
+		return NULL;
+	}
+}
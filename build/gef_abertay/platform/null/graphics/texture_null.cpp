@@ -1,10 +1,25 @@
-#include <graphics/texture.h>
-#include <cstddef> // for NULL definition
+#include <platform/null/graphics/texture_null.h>
 
 namespace gef
 {
 	Texture* Texture::Create(const Platform& platform, const ImageData& image_data)
 	{
-		return NULL;
+		return new TextureNull();
 	}
-}
\ No newline at end of file
+
+	TextureNull::TextureNull()
+	{
+	}
+
+	TextureNull::~TextureNull()
+	{
+	}
+
+	void TextureNull::Bind(const Platform& platform, const int texture_stage_num) const
+	{
+	}
+
+	void TextureNull::Unbind(const Platform& platform, const int texture_stage_num) const
+	{
+	}
+}
@@ -0,0 +1,20 @@
+#ifndef _GEF_TEXTURE_NULL_H
+#define _GEF_TEXTURE_NULL_H
+
+#include <graphics/texture.h>
+
+namespace gef
+{
+	// A texture with nothing to upload to, so assets with textures still load on the null platform
+	class TextureNull : public Texture
+	{
+	public:
+		TextureNull();
+		~TextureNull();
+
+		void Bind(const Platform& platform, const int texture_stage_num) const;
+		void Unbind(const Platform& platform, const int texture_stage_num) const;
+	};
+}
+
+#endif // _GEF_TEXTURE_NULL_H
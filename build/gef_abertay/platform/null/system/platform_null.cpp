@@ -0,0 +1,88 @@
+#include <platform/null/system/platform_null.h>
+#include <maths/matrix44.h>
+
+namespace gef
+{
+	PlatformNull::PlatformNull(Int32 width, Int32 height, float frame_time) :
+		frame_time_(frame_time)
+	{
+		set_width(width);
+		set_height(height);
+	}
+
+	PlatformNull::~PlatformNull()
+	{
+	}
+
+	bool PlatformNull::Update()
+	{
+		return true;
+	}
+
+	float PlatformNull::GetFrameTime()
+	{
+		// there is no display to sync to, so report a fixed frame time
+		return frame_time_;
+	}
+
+	void PlatformNull::PreRender()
+	{
+	}
+
+	void PlatformNull::PostRender()
+	{
+	}
+
+	void PlatformNull::Clear() const
+	{
+	}
+
+	std::string PlatformNull::FormatFilename(const std::string& filename) const
+	{
+		return filename;
+	}
+
+	std::string PlatformNull::FormatFilename(const char* filename) const
+	{
+		return std::string(filename);
+	}
+
+	Matrix44 PlatformNull::PerspectiveProjectionFov(const float fov, const float aspect_ratio, const float near_distance, const float far_distance) const
+	{
+		Matrix44 projection_matrix;
+		projection_matrix.PerspectiveFovD3D(fov, aspect_ratio, near_distance, far_distance);
+		return projection_matrix;
+	}
+
+	Matrix44 PlatformNull::PerspectiveProjectionFrustum(const float left, const float right, const float top, const float bottom, const float near_distance, const float far_distance) const
+	{
+		Matrix44 projection_matrix;
+		projection_matrix.PerspectiveFrustumD3D(left, right, top, bottom, near_distance, far_distance);
+		return projection_matrix;
+	}
+
+	Matrix44 PlatformNull::OrthographicFrustum(const float left, const float right, const float top, const float bottom, const float near_distance, const float far_distance) const
+	{
+		Matrix44 projection_matrix;
+		projection_matrix.OrthographicFrustumD3D(left, right, top, bottom, near_distance, far_distance);
+		return projection_matrix;
+	}
+
+	void PlatformNull::BeginScene() const
+	{
+	}
+
+	void PlatformNull::EndScene() const
+	{
+	}
+
+	const char* PlatformNull::GetShaderDirectory() const
+	{
+		return NULL;
+	}
+
+	const char* PlatformNull::GetShaderFileExtension() const
+	{
+		return NULL;
+	}
+}
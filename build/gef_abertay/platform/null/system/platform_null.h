@@ -0,0 +1,39 @@
+#ifndef _GEF_PLATFORM_NULL_H
+#define _GEF_PLATFORM_NULL_H
+
+#include <system/platform.h>
+
+namespace gef
+{
+	// Platform with no window, graphics device or audio device.
+	// Used to run game code headless, e.g. for benchmarks on build machines.
+	class PlatformNull : public Platform
+	{
+	public:
+		PlatformNull(Int32 width = 960, Int32 height = 544, float frame_time = 1.0f / 60.0f);
+		~PlatformNull();
+
+		bool Update();
+		float GetFrameTime();
+		void PreRender();
+		void PostRender();
+		void Clear() const;
+
+		std::string FormatFilename(const std::string& filename) const;
+		std::string FormatFilename(const char* filename) const;
+
+		Matrix44 PerspectiveProjectionFov(const float fov, const float aspect_ratio, const float near_distance, const float far_distance) const;
+		Matrix44 PerspectiveProjectionFrustum(const float left, const float right, const float top, const float bottom, const float near_distance, const float far_distance) const;
+		Matrix44 OrthographicFrustum(const float left, const float right, const float top, const float bottom, const float near_distance, const float far_distance) const;
+
+		void BeginScene() const;
+		void EndScene() const;
+		const char* GetShaderDirectory() const;
+		const char* GetShaderFileExtension() const;
+
+	private:
+		float frame_time_;
+	};
+}
+
+#endif // _GEF_PLATFORM_NULL_H
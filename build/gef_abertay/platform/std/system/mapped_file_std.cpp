@@ -0,0 +1,86 @@
+#include "mapped_file_std.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GEF_MAPPED_FILE_POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace gef
+{
+	MappedFile* MappedFile::Create()
+	{
+		return new MappedFileStd();
+	}
+
+	MappedFileStd::MappedFileStd() :
+		mapping_(NULL)
+	{
+	}
+
+	MappedFileStd::~MappedFileStd()
+	{
+		Close();
+	}
+
+	bool MappedFileStd::Open(const char* const filename)
+	{
+		Close();
+
+#ifdef GEF_MAPPED_FILE_POSIX
+		int file_descriptor = open(filename, O_RDONLY);
+		if(file_descriptor < 0)
+			return false;
+
+		struct stat file_stat;
+		bool success = fstat(file_descriptor, &file_stat) == 0 && file_stat.st_size <= 0x7fffffff;
+		if(success && file_stat.st_size > 0)
+		{
+			// copy-on-write, pages that are written to become private copies and the file is never changed
+			void* mapping = mmap(NULL, (size_t)file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file_descriptor, 0);
+			success = mapping != MAP_FAILED;
+			if(success)
+			{
+				mapping_ = mapping;
+				data_ = mapping;
+			}
+		}
+		else if(success)
+		{
+			// an empty file can't be mapped, but it is still a valid empty view
+			static const char empty = 0;
+			data_ = &empty;
+		}
+
+		// the mapping keeps its own reference to the file
+		close(file_descriptor);
+
+		if(success)
+			size_ = (Int32)file_stat.st_size;
+
+		return success;
+#else
+		bool success = buffered_file_.Open(filename);
+		if(success)
+		{
+			data_ = buffered_file_.data();
+			size_ = buffered_file_.size();
+		}
+		return success;
+#endif
+	}
+
+	void MappedFileStd::Close()
+	{
+#ifdef GEF_MAPPED_FILE_POSIX
+		if(mapping_)
+			munmap(mapping_, (size_t)size_);
+#endif
+		mapping_ = NULL;
+		buffered_file_.Close();
+		data_ = NULL;
+		size_ = 0;
+	}
+}
@@ -0,0 +1,25 @@
+#ifndef SYSTEM_STD_MAPPED_FILE_STD_H_
+#define SYSTEM_STD_MAPPED_FILE_STD_H_
+
+#include <system/mapped_file.h>
+
+namespace gef
+{
+	// Uses mmap where POSIX is available, otherwise reads the file into a buffer.
+	class MappedFileStd : public MappedFile
+	{
+	public:
+
+		MappedFileStd();
+		~MappedFileStd();
+
+		bool Open(const char* const filename);
+		void Close();
+
+	private:
+		void* mapping_;
+		BufferedMappedFile buffered_file_;
+	};
+}
+
+#endif /* SYSTEM_STD_MAPPED_FILE_STD_H_ */
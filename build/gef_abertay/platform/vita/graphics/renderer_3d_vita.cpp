@@ -13,6 +13,7 @@
 //#include <platform/vita/graphics/primitive_vita.h>
 #include <graphics/mesh_instance.h>
 #include <graphics/colour.h>
+#include <system/profiler.h>
 #include <gxm.h>
 
 namespace gef
@@ -56,6 +57,9 @@ namespace gef
 
     void Renderer3DVita::Begin(bool clear)
     {
+        GEF_PROFILE_ZONE("Renderer3D::Begin");
+        ResetFrame();
+
         const PlatformVita& platform_vita = static_cast<const PlatformVita&>(platform());
         platform_vita.BeginScene();
 
@@ -65,6 +69,9 @@ namespace gef
 
     void Renderer3DVita::End()
     {
+        GEF_PROFILE_ZONE("Renderer3D::End");
+        FlushSubmittedMeshes();
+
         const PlatformVita& platform_vita = static_cast<const PlatformVita&>(platform());
         platform_vita.EndScene();
     }
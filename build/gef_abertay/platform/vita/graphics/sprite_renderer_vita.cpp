@@ -9,6 +9,7 @@
 #include <system/platform.h>
 #include <graphics/vertex_buffer.h>
 #include <graphics/shader_interface.h>
+#include <system/profiler.h>
 
 
 extern const SceGxmProgram _binary_textured_sprite_v_gxp_start;
@@ -68,6 +69,7 @@ namespace gef
 
 	void SpriteRendererVita::Begin(bool clear)
 	{
+		GEF_PROFILE_ZONE("SpriteRenderer::Begin");
 		platform_.BeginScene();
 		if (clear)
 			platform_.Clear();
@@ -84,6 +86,7 @@ namespace gef
 
 	void SpriteRendererVita::End()
 	{
+		GEF_PROFILE_ZONE("SpriteRenderer::End");
 		vertex_buffer_->Unbind(platform_);
 
 		const PlatformVita& platform_vita = static_cast<const PlatformVita&>(platform_);
@@ -0,0 +1,10 @@
+#include <system/mapped_file.h>
+
+namespace gef
+{
+	// files on the Vita are read through FIOS, so read the whole file into memory
+	MappedFile* MappedFile::Create()
+	{
+		return new BufferedMappedFile();
+	}
+}
@@ -0,0 +1,86 @@
+#include <platform/win32/system/mapped_file_win32.h>
+
+namespace gef
+{
+	MappedFile* MappedFile::Create()
+	{
+		return new MappedFileWin32();
+	}
+
+	MappedFileWin32::MappedFileWin32() :
+		file_handle_(INVALID_HANDLE_VALUE),
+		mapping_handle_(NULL)
+	{
+	}
+
+	MappedFileWin32::~MappedFileWin32()
+	{
+		Close();
+	}
+
+	bool MappedFileWin32::Open(const char* const filename)
+	{
+		Close();
+
+		file_handle_ = CreateFile(filename,
+			GENERIC_READ,
+			FILE_SHARE_READ,
+			NULL,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL,
+			NULL);
+
+		if (file_handle_ == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file_handle_, &file_size) || file_size.HighPart != 0 || file_size.LowPart > 0x7fffffff)
+		{
+			Close();
+			return false;
+		}
+
+		// an empty file can't be mapped, but it is still a valid empty view
+		if (file_size.LowPart == 0)
+		{
+			static const char empty = 0;
+			data_ = &empty;
+			size_ = 0;
+			return true;
+		}
+
+		// copy-on-write, pages that are written to become private copies and the file is never changed
+		mapping_handle_ = CreateFileMapping(file_handle_, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+		if (mapping_handle_ != NULL)
+			data_ = MapViewOfFile(mapping_handle_, FILE_MAP_COPY, 0, 0, 0);
+
+		if (data_ == NULL)
+		{
+			Close();
+			return false;
+		}
+
+		size_ = static_cast<Int32>(file_size.LowPart);
+		return true;
+	}
+
+	void MappedFileWin32::Close()
+	{
+		if (mapping_handle_ != NULL)
+		{
+			if (data_ != NULL)
+				UnmapViewOfFile(data_);
+			CloseHandle(mapping_handle_);
+			mapping_handle_ = NULL;
+		}
+
+		if (file_handle_ != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(file_handle_);
+			file_handle_ = INVALID_HANDLE_VALUE;
+		}
+
+		data_ = NULL;
+		size_ = 0;
+	}
+}
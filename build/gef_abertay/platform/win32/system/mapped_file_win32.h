@@ -0,0 +1,27 @@
+#ifndef _GEF_MAPPED_FILE_WIN32_H
+#define _GEF_MAPPED_FILE_WIN32_H
+
+#include <system/mapped_file.h>
+#include <Windows.h>
+
+namespace gef
+{
+
+class MappedFileWin32 : public MappedFile
+{
+public:
+
+	MappedFileWin32();
+	~MappedFileWin32();
+
+	bool Open(const char* const filename);
+	void Close();
+
+private:
+	HANDLE file_handle_;
+	HANDLE mapping_handle_;
+};
+
+}
+
+#endif // _GEF_MAPPED_FILE_WIN32_H
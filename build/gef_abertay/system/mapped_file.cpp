@@ -0,0 +1,72 @@
+#include <system/mapped_file.h>
+#include <system/file.h>
+#include <cstdlib>
+
+namespace gef
+{
+	MappedFile::MappedFile() :
+		data_(NULL),
+		size_(0)
+	{
+	}
+
+	MappedFile::~MappedFile()
+	{
+	}
+
+	BufferedMappedFile::BufferedMappedFile() :
+		buffer_(NULL)
+	{
+	}
+
+	BufferedMappedFile::~BufferedMappedFile()
+	{
+		Close();
+	}
+
+	bool BufferedMappedFile::Open(const char* const filename)
+	{
+		Close();
+
+		File* file = File::Create();
+		bool success = file->Open(filename);
+		if(success)
+		{
+			Int32 file_size = 0;
+			success = file->GetSize(file_size);
+			if(success)
+			{
+				buffer_ = malloc(file_size > 0 ? file_size : 1);
+				success = buffer_ != NULL;
+			}
+
+			if(success)
+			{
+				Int32 bytes_read = 0;
+				success = file->Read(buffer_, file_size, bytes_read) && bytes_read == file_size;
+			}
+
+			if(success)
+			{
+				data_ = buffer_;
+				size_ = file_size;
+			}
+
+			file->Close();
+		}
+		delete file;
+
+		if(!success)
+			Close();
+
+		return success;
+	}
+
+	void BufferedMappedFile::Close()
+	{
+		free(buffer_);
+		buffer_ = NULL;
+		data_ = NULL;
+		size_ = 0;
+	}
+}
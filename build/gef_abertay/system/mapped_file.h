@@ -0,0 +1,59 @@
+#ifndef _GEF_MAPPED_FILE_H
+#define _GEF_MAPPED_FILE_H
+
+#include <gef.h>
+
+namespace gef
+{
+	/// @brief A private view of the whole contents of a file.
+	///
+	/// Platforms that can map files into memory do so, which means nothing is copied until the
+	/// data is used. Other platforms read the file into a buffer instead, see BufferedMappedFile.
+	/// The view is copy-on-write, so data read from it can be fixed up in place without the file changing.
+	/// The data stays valid until Close is called or the object is deleted.
+	class MappedFile
+	{
+	public:
+		virtual ~MappedFile();
+
+		/// @brief Map the whole of a file into memory.
+		/// @param[in] filename		The name of the file.
+		/// @return If the file was mapped successfully.
+		virtual bool Open(const char* const filename) = 0;
+
+		/// @brief Unmap the file. Any pointers into the data are no longer valid.
+		virtual void Close() = 0;
+
+		/// @return The start of the file's contents, or NULL if no file is open.
+		inline const void* data() const { return data_; }
+
+		/// @return The size of the file's contents in bytes.
+		inline Int32 size() const { return size_; }
+
+		/// @brief Create the MappedFile for the current platform.
+		static MappedFile* Create();
+
+	protected:
+		MappedFile();
+
+		const void* data_;
+		Int32 size_;
+	};
+
+	/// @brief A MappedFile that reads the whole file into a heap buffer through gef::File.
+	/// Used on platforms that can't map files into memory.
+	class BufferedMappedFile : public MappedFile
+	{
+	public:
+		BufferedMappedFile();
+		~BufferedMappedFile();
+
+		bool Open(const char* const filename);
+		void Close();
+
+	private:
+		void* buffer_;
+	};
+}
+
+#endif // _GEF_MAPPED_FILE_H
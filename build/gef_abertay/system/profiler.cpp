@@ -0,0 +1,452 @@
+#include <system/profiler.h>
+
+#ifdef GEF_PROFILER
+#include <system/debug_log.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#endif
+
+namespace gef
+{
+#ifdef GEF_PROFILER
+	// zones a thread can record between two frames before the oldest are overwritten
+	static const UInt32 kRingBufferSize = 16384;
+
+	// A zone that has ended
+	struct ZoneRecord
+	{
+		const char* name;
+		Int64 start_ns;
+		Int64 end_ns;
+		UInt32 thread_id;
+	};
+
+	// A zone that has begun but not ended
+	struct OpenZone
+	{
+		const char* name;
+		Int64 start_ns;
+	};
+
+	// The zones recorded by one thread
+	struct ThreadBuffer
+	{
+		ThreadBuffer(UInt32 id) :
+			write_count(0),
+			read_count(0),
+			thread_id(id),
+			exited(false)
+		{
+			open_zones.reserve(32);
+		}
+
+		std::mutex mutex;					// held by the thread while it writes a record and by NextFrame while it reads them
+		std::vector<ZoneRecord> records;	// the ring buffer, allocated when the first zone is recorded
+		UInt64 write_count;
+		UInt64 read_count;					// only used by NextFrame
+		std::vector<OpenZone> open_zones;	// only used by the thread
+		UInt32 thread_id;
+		bool exited;						// guarded by the registry mutex
+	};
+
+	// The buffers of every thread that has used the profiler, and the names of the threads
+	struct ThreadRegistry
+	{
+		~ThreadRegistry()
+		{
+			for(std::vector<ThreadBuffer*>::iterator buffer_iter = buffers.begin(); buffer_iter != buffers.end(); ++buffer_iter)
+				delete *buffer_iter;
+		}
+
+		std::mutex mutex;
+		std::vector<ThreadBuffer*> buffers;
+		std::vector<std::string> thread_names;
+	};
+	static ThreadRegistry registry;
+
+	// Gives a thread's buffer back to the registry when the thread exits, so it is deleted once it has been read
+	struct ThreadBufferOwner
+	{
+		ThreadBufferOwner() :
+			buffer(NULL)
+		{
+		}
+
+		~ThreadBufferOwner()
+		{
+			if(buffer)
+			{
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				buffer->exited = true;
+			}
+		}
+
+		ThreadBuffer* buffer;
+	};
+	static thread_local ThreadBufferOwner thread_buffer_owner;
+
+	// Time in zones per frame, summed for the summary
+	struct ZoneTotals
+	{
+		const char* name;
+		Int64 total_ns;
+		UInt32 calls;
+	};
+
+	// Allocation counts at the end of a captured frame
+	struct FrameCounters
+	{
+		Int64 time_ns;
+		UInt64 allocations;
+		UInt64 allocated_bytes;
+		UInt64 frees;
+	};
+
+	// shared with every thread
+	static std::atomic<bool> recording(false);
+	static std::atomic<UInt64> allocation_count(0);
+	static std::atomic<UInt64> allocated_bytes(0);
+	static std::atomic<UInt64> free_count(0);
+	static const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+	// only used on the main thread
+	static bool user_enabled = false;
+	static Int64 frame_start_ns = 0;
+	static UInt64 last_allocation_count = 0;
+	static UInt64 last_allocated_bytes = 0;
+	static UInt64 last_free_count = 0;
+	static UInt64 dropped_zones = 0;
+	static std::vector<ZoneRecord> drained_records;
+
+	static std::vector<ZoneTotals> summary_totals;
+	static Int32 summary_frames = 0;
+	static Int64 summary_frame_ns = 0;
+	static UInt64 summary_allocations = 0;
+	static UInt64 summary_allocated_bytes = 0;
+	static UInt64 summary_frees = 0;
+	static ProfileSummary last_summary;
+
+	static bool capture_active = false;
+	static Int32 capture_frames_left = 0;
+	static std::string capture_filename;
+	static std::vector<ZoneRecord> capture_records;
+	static std::vector<FrameCounters> capture_counters;
+
+	// nanoseconds since the program started
+	static Int64 Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+	}
+
+	static ThreadBuffer* GetThreadBuffer()
+	{
+		if(!thread_buffer_owner.buffer)
+		{
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			const UInt32 thread_id = (UInt32)registry.thread_names.size();
+			registry.thread_names.push_back("thread " + std::to_string(thread_id));
+			thread_buffer_owner.buffer = new ThreadBuffer(thread_id);
+			registry.buffers.push_back(thread_buffer_owner.buffer);
+		}
+
+		return thread_buffer_owner.buffer;
+	}
+
+	// write a string to a JSON file with quotes and anything that needs escaping escaped
+	static void WriteJsonString(std::ofstream& file, const char* text)
+	{
+		file << '"';
+		for(const char* c = text; *c; ++c)
+		{
+			if(*c == '"' || *c == '\\')
+				file << '\\' << *c;
+			else if((unsigned char)*c < 0x20)
+				file << ' ';
+			else
+				file << *c;
+		}
+		file << '"';
+	}
+
+	static void WriteTrace()
+	{
+		std::ofstream file(capture_filename.c_str(), std::ios::out | std::ios::trunc);
+		if(!file.is_open())
+		{
+			DebugOut("Profiler: can't write trace file %s\n", capture_filename.c_str());
+			return;
+		}
+
+		std::vector<std::string> thread_names;
+		{
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			thread_names = registry.thread_names;
+		}
+
+		char line[256];
+		bool first_event = true;
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		for(UInt32 thread_id = 0; thread_id < (UInt32)thread_names.size(); ++thread_id)
+		{
+			file << (first_event ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread_id << ",\"args\":{\"name\":";
+			WriteJsonString(file, thread_names[thread_id].c_str());
+			file << "}}";
+			first_event = false;
+		}
+
+		// complete events, times are in microseconds
+		for(std::vector<ZoneRecord>::const_iterator record = capture_records.begin(); record != capture_records.end(); ++record)
+		{
+			file << (first_event ? "" : ",\n") << "{\"name\":";
+			WriteJsonString(file, record->name);
+			snprintf(line, sizeof(line), ",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				record->thread_id, record->start_ns / 1000.0, (record->end_ns - record->start_ns) / 1000.0);
+			file << line;
+			first_event = false;
+		}
+
+		// allocations made during each frame
+		for(std::vector<FrameCounters>::const_iterator counters = capture_counters.begin(); counters != capture_counters.end(); ++counters)
+		{
+			snprintf(line, sizeof(line), "{\"name\":\"allocations\",\"ph\":\"C\",\"pid\":0,\"ts\":%.3f,\"args\":{\"allocations\":%llu,\"frees\":%llu,\"kb\":%.3f}}",
+				counters->time_ns / 1000.0, counters->allocations, counters->frees, counters->allocated_bytes / 1024.0);
+			file << (first_event ? "" : ",\n") << line;
+			first_event = false;
+		}
+
+		file << "\n]}\n";
+	}
+
+	static bool CompareZoneStats(const ProfileZoneStats& a, const ProfileZoneStats& b)
+	{
+		return a.ms > b.ms;
+	}
+
+	static void PublishSummary()
+	{
+		const float frames = (float)summary_frames;
+
+		last_summary.num_frames = summary_frames;
+		last_summary.frame_ms = summary_frame_ns / 1000000.0f / frames;
+		last_summary.allocations = summary_allocations / frames;
+		last_summary.allocated_kb = summary_allocated_bytes / 1024.0f / frames;
+		last_summary.frees = summary_frees / frames;
+		last_summary.dropped_zones = dropped_zones;
+
+		last_summary.zones.clear();
+		for(std::vector<ZoneTotals>::const_iterator totals = summary_totals.begin(); totals != summary_totals.end(); ++totals)
+		{
+			ProfileZoneStats stats;
+			stats.name = totals->name;
+			stats.ms = totals->total_ns / 1000000.0f / frames;
+			stats.calls = totals->calls / frames;
+			last_summary.zones.push_back(stats);
+		}
+		std::sort(last_summary.zones.begin(), last_summary.zones.end(), CompareZoneStats);
+
+		summary_totals.clear();
+		summary_frames = 0;
+		summary_frame_ns = 0;
+		summary_allocations = 0;
+		summary_allocated_bytes = 0;
+		summary_frees = 0;
+	}
+
+	void Profiler::NextFrame()
+	{
+		const Int64 now = Now();
+
+		static bool main_thread_named = false;
+		if(!main_thread_named)
+		{
+			SetThreadName("main");
+			main_thread_named = true;
+		}
+		const UInt32 main_thread_id = GetThreadBuffer()->thread_id;
+
+		// read everything recorded since the last frame
+		drained_records.clear();
+		{
+			std::lock_guard<std::mutex> registry_lock(registry.mutex);
+			for(size_t buffer_num = 0; buffer_num < registry.buffers.size(); ++buffer_num)
+			{
+				ThreadBuffer* buffer = registry.buffers[buffer_num];
+				{
+					std::lock_guard<std::mutex> lock(buffer->mutex);
+					if(buffer->write_count - buffer->read_count > kRingBufferSize)
+					{
+						dropped_zones += buffer->write_count - buffer->read_count - kRingBufferSize;
+						buffer->read_count = buffer->write_count - kRingBufferSize;
+					}
+
+					for(; buffer->read_count < buffer->write_count; ++buffer->read_count)
+						drained_records.push_back(buffer->records[buffer->read_count % kRingBufferSize]);
+				}
+
+				if(buffer->exited)
+				{
+					delete buffer;
+					registry.buffers.erase(registry.buffers.begin() + buffer_num);
+					--buffer_num;
+				}
+			}
+		}
+
+		// add the zones to the summary, there are only ever a few different names so a linear search is fine
+		for(std::vector<ZoneRecord>::const_iterator record = drained_records.begin(); record != drained_records.end(); ++record)
+		{
+			std::vector<ZoneTotals>::iterator totals = summary_totals.begin();
+			while(totals != summary_totals.end() && totals->name != record->name)
+				++totals;
+
+			if(totals == summary_totals.end())
+			{
+				ZoneTotals new_totals = { record->name, 0, 0 };
+				summary_totals.push_back(new_totals);
+				totals = summary_totals.end() - 1;
+			}
+
+			totals->total_ns += record->end_ns - record->start_ns;
+			totals->calls++;
+		}
+
+		const UInt64 allocations = allocation_count.load(std::memory_order_relaxed);
+		const UInt64 bytes = allocated_bytes.load(std::memory_order_relaxed);
+		const UInt64 frees = free_count.load(std::memory_order_relaxed);
+		FrameCounters frame_counters = { now, allocations - last_allocation_count, bytes - last_allocated_bytes, frees - last_free_count };
+		last_allocation_count = allocations;
+		last_allocated_bytes = bytes;
+		last_free_count = frees;
+
+		summary_frames++;
+		summary_frame_ns += now - frame_start_ns;
+		summary_allocations += frame_counters.allocations;
+		summary_allocated_bytes += frame_counters.allocated_bytes;
+		summary_frees += frame_counters.frees;
+		if(summary_frames >= kSummaryFrames)
+			PublishSummary();
+
+		if(capture_active)
+		{
+			capture_records.insert(capture_records.end(), drained_records.begin(), drained_records.end());
+			ZoneRecord frame_record = { "Frame", frame_start_ns, now, main_thread_id };
+			capture_records.push_back(frame_record);
+			capture_counters.push_back(frame_counters);
+
+			if(--capture_frames_left <= 0)
+			{
+				WriteTrace();
+				capture_active = false;
+				std::vector<ZoneRecord>().swap(capture_records);
+				std::vector<FrameCounters>().swap(capture_counters);
+				recording.store(user_enabled, std::memory_order_relaxed);
+			}
+		}
+
+		frame_start_ns = now;
+	}
+
+	void Profiler::SetEnabled(const bool enabled)
+	{
+		user_enabled = enabled;
+		recording.store(user_enabled || capture_active, std::memory_order_relaxed);
+	}
+
+	bool Profiler::enabled()
+	{
+		return user_enabled;
+	}
+
+	bool Profiler::BeginZone(const char* name)
+	{
+		if(!recording.load(std::memory_order_relaxed))
+			return false;
+
+		OpenZone zone = { name, Now() };
+		GetThreadBuffer()->open_zones.push_back(zone);
+		return true;
+	}
+
+	void Profiler::EndZone()
+	{
+		// only called for zones BeginZone opened, but don't pop a stack that isn't there
+		ThreadBuffer* buffer = thread_buffer_owner.buffer;
+		if(!buffer || buffer->open_zones.empty())
+			return;
+
+		const OpenZone zone = buffer->open_zones.back();
+		buffer->open_zones.pop_back();
+		if(!recording.load(std::memory_order_relaxed))
+			return;
+
+		ZoneRecord record = { zone.name, zone.start_ns, Now(), buffer->thread_id };
+
+		std::lock_guard<std::mutex> lock(buffer->mutex);
+		if(buffer->records.empty())
+			buffer->records.resize(kRingBufferSize);
+		buffer->records[buffer->write_count % kRingBufferSize] = record;
+		buffer->write_count++;
+	}
+
+	void Profiler::SetThreadName(const char* name)
+	{
+		ThreadBuffer* buffer = GetThreadBuffer();
+
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.thread_names[buffer->thread_id] = name;
+	}
+
+	void Profiler::CountAllocation(const size_t size)
+	{
+		allocation_count.fetch_add(1, std::memory_order_relaxed);
+		allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+	}
+
+	void Profiler::CountFree()
+	{
+		free_count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool Profiler::CaptureTrace(const char* filename, const Int32 num_frames)
+	{
+		if(capture_active || !filename || num_frames <= 0)
+			return false;
+
+		capture_active = true;
+		capture_frames_left = num_frames;
+		capture_filename = filename;
+		recording.store(true, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool Profiler::capturing()
+	{
+		return capture_active;
+	}
+
+	const ProfileSummary& Profiler::summary()
+	{
+		return last_summary;
+	}
+#else
+	static ProfileSummary last_summary;
+
+	void Profiler::NextFrame() {}
+	void Profiler::SetEnabled(const bool enabled) {}
+	bool Profiler::enabled() { return false; }
+	bool Profiler::BeginZone(const char* name) { return false; }
+	void Profiler::EndZone() {}
+	void Profiler::SetThreadName(const char* name) {}
+	void Profiler::CountAllocation(const size_t size) {}
+	void Profiler::CountFree() {}
+	bool Profiler::CaptureTrace(const char* filename, const Int32 num_frames) { return false; }
+	bool Profiler::capturing() { return false; }
+	const ProfileSummary& Profiler::summary() { return last_summary; }
+#endif
+}
@@ -0,0 +1,92 @@
+#ifndef _GEF_PROFILER_H
+#define _GEF_PROFILER_H
+
+#include <gef.h>
+#include <cstddef>
+#include <vector>
+
+// GEF_PROFILER is defined when the profiler is built in.
+// Define GEF_NO_PROFILER in the project settings to compile out every profile zone and leave the Profiler functions empty.
+#if !defined(GEF_NO_PROFILER)
+#define GEF_PROFILER
+#endif
+
+namespace gef
+{
+	// Time spent in one zone, per frame
+	struct ProfileZoneStats
+	{
+		const char* name;
+		float ms;			// summed over every thread
+		float calls;
+	};
+
+	// Averages over the last Profiler::kSummaryFrames frames
+	struct ProfileSummary
+	{
+		Int32 num_frames;
+		float frame_ms;
+		float allocations;		// per frame
+		float allocated_kb;		// per frame
+		float frees;			// per frame
+		UInt64 dropped_zones;	// zones overwritten in a ring buffer before they were read, since the start
+		std::vector<ProfileZoneStats> zones;	// slowest first
+	};
+
+	// Records named zones on every thread into a ring buffer for each thread.
+	// The buffers are read once a frame by NextFrame, which keeps a summary of where the frame went
+	// and can write the zones of a number of frames to a Chrome trace file (chrome://tracing or ui.perfetto.dev).
+	// Nothing is recorded until the profiler is enabled or a trace is being captured.
+	class Profiler
+	{
+	public:
+		static const Int32 kSummaryFrames = 30;
+
+		// End the current frame and start the next one. Call once a frame on the main thread.
+		static void NextFrame();
+
+		static void SetEnabled(const bool enabled);
+		static bool enabled();
+
+		// Zones are usually marked with GEF_PROFILE_ZONE. The name must be a string that lasts as long as the program, like a literal.
+		// BeginZone returns false if the profiler isn't recording, and EndZone must only be called for zones that were begun.
+		static bool BeginZone(const char* name);
+		static void EndZone();
+
+		// Name the calling thread in traces
+		static void SetThreadName(const char* name);
+
+		// Called by a replacement global operator new and delete, if the program has one
+		static void CountAllocation(const size_t size);
+		static void CountFree();
+
+		// Record the next num_frames frames and write them to a Chrome trace_event JSON file once they are done.
+		// Returns false if a trace is already being captured.
+		static bool CaptureTrace(const char* filename, const Int32 num_frames);
+		static bool capturing();
+
+		static const ProfileSummary& summary();
+	};
+
+	// Marks a zone from construction until destruction
+	class ProfileZone
+	{
+	public:
+		explicit ProfileZone(const char* name) : begun_(Profiler::BeginZone(name)) {}
+		~ProfileZone() { if(begun_) Profiler::EndZone(); }
+
+	private:
+		// only the zones that were begun are ended, so turning the profiler on inside a zone doesn't end the wrong one
+		bool begun_;
+	};
+}
+
+#ifdef GEF_PROFILER
+#define GEF_PROFILE_CONCAT_LINE(name, line) name##line
+#define GEF_PROFILE_ZONE_NAME(line) GEF_PROFILE_CONCAT_LINE(gef_profile_zone_, line)
+#define GEF_PROFILE_ZONE(name) gef::ProfileZone GEF_PROFILE_ZONE_NAME(__LINE__)(name)
+#else
+#define GEF_PROFILE_ZONE(name)
+#endif
+
+#endif // _GEF_PROFILER_H
@@ -13,6 +13,7 @@ int main(int argc, char* argv[])
 	char* output_filename = "output.scn";
 	char* input_filename = "";
 	bool animation_only = false;
+	bool stream_format = false;
 
 
 	gef::FBXLoader fbx_loader;
@@ -145,6 +146,11 @@ int main(int argc, char* argv[])
 					if (scaling_factor != 0.0f)
 						fbx_loader.set_scaling_factor(scaling_factor);
 				}
+				else if (stricmp(&argv[arg_num][1], "stream-format") == 0)
+				{
+					// write the older stream format instead of the mapped format
+					stream_format = true;
+				}
 				break;
 
 			case 't':
@@ -176,7 +182,10 @@ int main(int argc, char* argv[])
 	{
 		std::cout << "file: " << input_filename << " loaded." << std::endl << std::endl;
 		std::cout << "Writing output file: " << output_filename << std::endl;
-		success = scene.WriteSceneToFile(platform, output_filename);
+		if(stream_format)
+			success = scene.WriteSceneToFile(platform, output_filename);
+		else
+			success = scene.WriteMappedSceneToFile(platform, output_filename);
 		if(success)
 			std::cout << "Success." << std::endl;
 		else